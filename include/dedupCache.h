@@ -0,0 +1,69 @@
+// Content-hash deduplication cache for incoming notifications.
+// Identical title/message pairs from the same session (optionally scoped by a client
+// idempotency key) received within the configured time window resolve to the
+// notification that is already showing instead of producing a new toast. Sessions
+// never share notifications, since only the owner may update or delete one.
+
+#ifndef DEDUP_CACHE_H
+#define DEDUP_CACHE_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <cstdint>
+
+struct DedupStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t capacity = 0;
+    size_t memoryBytes = 0;
+};
+
+class DedupCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    DedupCache(size_t capacity, Clock::duration window);
+
+    static uint64_t hashContent(const std::string& sessionID, const std::string& title, const std::string& message,
+        const std::string& idempotencyKey);
+    // Hashes a templated notification by its template and parameters, without rendering it.
+    static uint64_t hashTemplate(const std::string& sessionID, uint64_t templateFingerprint, const std::vector<std::string>& parameters,
+        const std::string& idempotencyKey);
+
+    std::optional<std::string> lookup(uint64_t hash, Clock::time_point now);
+    void insert(uint64_t hash, const std::string& notificationID, Clock::time_point now);
+    void invalidate(const std::string& notificationID);
+    void clear();
+
+    DedupStats getStats() const;
+
+private:
+    struct Slot {
+        bool occupied = false;
+        uint64_t hash = 0;
+        uint64_t lastUsed = 0;
+        Clock::time_point insertedAt;
+        std::string notificationID;
+    };
+
+    std::vector<Slot> slots;
+    // Lets invalidate() probe straight for a notification's slot instead of scanning.
+    std::unordered_map<std::string, uint64_t> hashByNotification;
+    size_t mask;
+    size_t entries = 0;
+    uint64_t tick = 0;
+    Clock::duration window;
+    DedupStats stats;
+
+    size_t findSlot(uint64_t hash) const;
+    void eraseAt(size_t index);
+    void purgeExpired(Clock::time_point now);
+    void evictLeastRecentlyUsed();
+};
+
+#endif // DEDUP_CACHE_H
@@ -0,0 +1,24 @@
+// This file provides an interface for Linux specific functionality
+// This file includes methods for
+//		1. Display a desktop notification through org.freedesktop.Notifications
+//		2. Replace or close a notification that is already showing
+//
+// All calls only queue a request and return. A worker thread owns one persistent
+// session bus connection, sends whatever has queued up in one go, and collects the
+// server's replies asynchronously, so many notifications can be in flight at once.
+
+#ifndef LINUX_API_H
+#define LINUX_API_H
+
+#include <string>
+
+class LinuxAPI {
+public:
+    // key identifies the notification on our side; showing the same key again replaces
+    // the notification in place instead of stacking a new one.
+    static void showNotification(const std::string& key, const std::string& title, const std::string& message);
+    static void closeNotification(const std::string& key);
+    static void cleanup();
+};
+
+#endif // LINUX_API_H
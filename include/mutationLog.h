@@ -0,0 +1,78 @@
+// Ordered log of notification state changes made by NotificationManager.
+// Every create/update/remove gets a monotonically increasing sequence number.
+// When retention is on (replication leaders), the most recent entries are kept, up to an
+// entry count and a byte limit, so replicas can catch up from an offset; a replica that
+// asks for something older gets a snapshot instead.
+
+#ifndef MUTATION_LOG_H
+#define MUTATION_LOG_H
+
+#include "notification.h"
+#include <string>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <cstdint>
+
+enum class MutationType {
+    Created,
+    Updated,
+    Removed,
+    Evicted,
+};
+
+const char* mutationTypeToString(MutationType type);
+MutationType parseMutationType(const std::string& type);
+
+struct Mutation {
+    uint64_t sequence = 0;
+    MutationType type = MutationType::Created;
+    std::string sessionID;
+    std::string notificationID;
+    std::string title;
+    std::string message;
+    // Set instead of title/message for templated notifications, so nothing is rendered
+    // unless the mutation is actually sent somewhere.
+    std::shared_ptr<const NotificationTemplate> notificationTemplate;
+    std::vector<std::string> templateParameters;
+    PriorityEnum priority = PriorityEnum::Normal;
+    int64_t timestampMs = 0;
+
+    std::string renderTitle() const;
+    std::string renderMessage() const;
+    // Bytes this entry pins while retained, including a template it references.
+    size_t getMemoryFootprint() const;
+};
+
+class MutationLog {
+public:
+    MutationLog(size_t capacity, size_t byteCapacity);
+
+    void append(Mutation mutation);
+    size_t subscribe(std::function<void(const Mutation&)> listener);
+    void unsubscribe(size_t subscriptionID);
+
+    // Copies every retained mutation with sequence >= fromSequence into `out`.
+    // Returns false if some of them have already been dropped from the log.
+    bool readFrom(uint64_t fromSequence, std::vector<Mutation>& out) const;
+
+    uint64_t getLastSequence() const;
+    const std::string& getLogID() const;
+
+    void setRetained(bool retained);
+    size_t getRetainedBytes() const;
+
+private:
+    size_t capacity;
+    size_t byteCapacity;
+    bool retained = false;
+    size_t retainedBytes = 0;
+    uint64_t lastSequence = 0;
+    std::string logID;
+    std::deque<Mutation> entries;
+    size_t nextSubscriptionID = 0;
+    std::vector<std::pair<size_t, std::function<void(const Mutation&)>>> listeners;
+};
+
+#endif // MUTATION_LOG_H
@@ -1,7 +1,10 @@
 #ifndef NOTIFICATION_H
 #define NOTIFICATION_H
 
+#include "notificationTemplate.h"
 #include <string>
+#include <vector>
+#include <memory>
 #include <chrono>
 
 enum class StatusEnum {
@@ -10,6 +13,15 @@ enum class StatusEnum {
     Unknown,
 };
 
+enum class PriorityEnum {
+    Low,
+    Normal,
+    High,
+};
+
+PriorityEnum parsePriority(const std::string& priority);
+const char* priorityToString(PriorityEnum priority);
+
 class Notification {
 public:
     Notification(const std::string& title,
@@ -17,27 +29,43 @@ public:
         const std::string& notificationID,
         const std::string& sessionID,
         StatusEnum status,
+        PriorityEnum priority,
         std::chrono::system_clock::time_point creationTime);
 
-    // Getters
+    // Getters; a templated notification renders its title and message on first use and
+    // keeps them until its template or parameters change
     const std::string& getTitle() const;
     const std::string& getMessage() const;
     const std::string& getNotificationID() const;
     const std::string& getSessionID() const;
     StatusEnum getStatus() const;
+    PriorityEnum getPriority() const;
     std::chrono::system_clock::time_point getCreationTime() const;
+    size_t getMemoryFootprint() const;
+    const std::shared_ptr<const NotificationTemplate>& getTemplate() const;
+    const std::vector<std::string>& getTemplateParameters() const;
 
-    // Setters
+    // Setters; setting the title or message of a templated notification turns it into
+    // plain text, keeping the other field as currently rendered.
     void setTitle(const std::string& title);
     void setMessage(const std::string& message);
+    void setPriority(PriorityEnum priority);
+    void setTemplate(std::shared_ptr<const NotificationTemplate> notificationTemplate, std::vector<std::string> parameters);
 
 private:
-    std::string _title;
-    std::string _message;
+    // For templated notifications these hold the rendered text once _rendered is set
+    mutable std::string _title;
+    mutable std::string _message;
+    mutable bool _rendered = false;
+    std::shared_ptr<const NotificationTemplate> _template;
+    std::vector<std::string> _templateParameters;
     std::string _notificationID;
     std::string _sessionID;
     StatusEnum _status;
+    PriorityEnum _priority;
     std::chrono::system_clock::time_point _creationTime;
+
+    void renderTemplate() const;
 };
 
 class NotificationBuilder {
@@ -47,7 +75,9 @@ public:
     NotificationBuilder& setNotificationID(const std::string& notificationID);
     NotificationBuilder& setSessionID(const std::string& sessionID);
     NotificationBuilder& setStatus(StatusEnum status);
+    NotificationBuilder& setPriority(PriorityEnum priority);
     NotificationBuilder& setCreationTime(std::chrono::system_clock::time_point creationTime);
+    NotificationBuilder& setTemplate(std::shared_ptr<const NotificationTemplate> notificationTemplate, std::vector<std::string> parameters);
 
     Notification build() const;
 
@@ -57,7 +87,10 @@ private:
     std::string _notificationID = "Default NotificationID";
     std::string _sessionID = "Default SessionID";
     StatusEnum _status = StatusEnum::Unknown;
+    PriorityEnum _priority = PriorityEnum::Normal;
     std::chrono::system_clock::time_point _creationTime = std::chrono::system_clock::now();
+    std::shared_ptr<const NotificationTemplate> _template;
+    std::vector<std::string> _templateParameters;
 };
 
 #endif // NOTIFICATION_H
\ No newline at end of file
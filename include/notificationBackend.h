@@ -0,0 +1,19 @@
+// Routes notification display to the platform's notification service: WindowsAPI toasts
+// on Windows and org.freedesktop.Notifications (LinuxAPI) on Linux.
+//
+// Notifications are identified by a key, normally the notificationID, so backends that
+// support it can replace a notification in place on update and withdraw it on removal.
+
+#ifndef NOTIFICATION_BACKEND_H
+#define NOTIFICATION_BACKEND_H
+
+#include <string>
+
+class NotificationBackend {
+public:
+    static void show(const std::string& key, const std::string& title, const std::string& message);
+    static void close(const std::string& key);
+    static void cleanup();
+};
+
+#endif // NOTIFICATION_BACKEND_H
@@ -2,25 +2,72 @@
 #define NOTIFICATION_MANAGER_H
 
 #include "notification.h"
+#include "notificationTemplate.h"
+#include "dedupCache.h"
+#include "mutationLog.h"
 #include <string>
 #include <unordered_map>
 #include <set>
+#include <vector>
+#include <list>
+#include <memory>
+#include <functional>
+#include <chrono>
 #include <bitset>
 #include <optional>
 #include <nlohmann/json.hpp>
 
+struct DigestStats {
+    uint64_t notificationsDigested = 0;
+    uint64_t digestsDelivered = 0;
+    uint64_t deliveriesSaved = 0;
+    size_t pendingNotifications = 0;
+};
+
+struct MemoryStats {
+    size_t totalBytes = 0;
+    size_t globalBudget = 0;
+    size_t sessionBudget = 0;
+    uint64_t evictions = 0;
+    std::unordered_map<std::string, size_t> sessionBytes;
+};
+
 class NotificationManager {
 public:
     static NotificationManager& getInstance();
 
     void addSession(const std::string& sessionID);
+    // Templates are scoped to the registering session. Returns the number of parameters the template takes.
+    size_t registerTemplate(const std::string& sessionID, const std::string& templateID, const std::string& title, const std::string& message);
     std::string createNotification(const std::string& sessionID, const nlohmann::json& payload);
+    // Creates a notification without deduplication; used directly when applying replicated state.
+    std::string storeNotification(const std::string& sessionID, const std::string& title, const std::string& msg,
+        PriorityEnum priority, bool display);
     void updateNotification(const std::string& sessionID, const std::string& notificationID, const nlohmann::json& payload);
     void removeNotification(const std::string& sessionID, const std::string& notificationID);
     void removeSession(const std::string& sessionID);
     void displayNotification(const std::string& sessionID, const std::string& notificationID);
     void displayAllNotifications(const std::string& sessionID);
 
+    void enableDeduplication(size_t capacity, std::chrono::seconds window);
+    std::optional<DedupStats> getDedupStats() const;
+
+    // A maxBatchSize of 0 delivers digests on the interval only.
+    void enableDigest(std::chrono::seconds interval, size_t maxBatchSize);
+    void flushDueDigests();
+    std::optional<DigestStats> getDigestStats() const;
+
+    // Budgets are in bytes; 0 means unlimited.
+    void setMemoryBudget(size_t globalBytes, size_t sessionBytes);
+    void setEvictionListener(std::function<void(const std::string& sessionID, const std::string& notificationID)> listener);
+    MemoryStats getMemoryStats() const;
+
+    MutationLog& getMutationLog();
+    // Mutations are only built and logged while something consumes them (a replication
+    // leader or a watcher); otherwise creates and updates pay nothing for the log.
+    void setMutationRecording(bool enabled);
+    std::vector<Mutation> snapshotNotifications() const;
+
     std::set<std::string> getActiveSessions(); 
     std::unordered_map<std::string, std::pair<std::string, std::string>> getActiveNotifications(); 
 
@@ -30,6 +77,49 @@ private:
     std::unordered_map<std::string, std::unique_ptr<Notification>> notifications;
     std::unordered_map<std::string, std::set<std::string>> sessionToNotificationMap;
     std::bitset<256> usedNotificationIDs;
+    std::optional<DedupCache> dedupCache;
+    MutationLog mutationLog{ 10000, 16 * 1024 * 1024 };
+    bool mutationRecording = false;
+
+    void logMutation(MutationType type, const Notification& notification);
+    std::string insertNotification(const std::string& sessionID, NotificationBuilder builder, bool display);
+
+    static constexpr size_t MAX_TEMPLATES_PER_SESSION = 64;
+    std::unordered_map<std::string, std::unordered_map<std::string, std::shared_ptr<const NotificationTemplate>>> sessionTemplates;
+
+    std::shared_ptr<const NotificationTemplate> findTemplate(const std::string& sessionID, const std::string& templateID) const;
+    static std::vector<std::string> parseTemplateParameters(const nlohmann::json& parameters, const NotificationTemplate& notificationTemplate);
+
+    struct DigestBuffer {
+        std::vector<std::string> notificationIDs;
+        std::chrono::steady_clock::time_point firstQueuedAt;
+    };
+    bool digestEnabled = false;
+    std::chrono::seconds digestInterval{ 0 };
+    size_t digestMaxBatchSize = 0;
+    std::unordered_map<std::string, DigestBuffer> sessionDigests;
+    DigestStats digestStats;
+
+    void deliverNotification(const std::string& sessionID, const std::string& notificationID);
+    void queueForDigest(const std::string& sessionID, const std::string& notificationID);
+    void dropFromDigest(const std::string& sessionID, const std::string& notificationID);
+    void flushDigest(const std::string& sessionID);
+
+    size_t globalMemoryBudget = 0;
+    size_t sessionMemoryBudget = 0;
+    size_t totalMemoryUsage = 0;
+    uint64_t memoryEvictions = 0;
+    std::unordered_map<std::string, size_t> sessionMemoryUsage;
+    std::list<std::string> recencyList;
+    std::unordered_map<std::string, std::list<std::string>::iterator> recencyIndex;
+    std::function<void(const std::string&, const std::string&)> evictionListener;
+
+    void reserveMemory(const std::string& sessionID, const std::string& protectedID, size_t footprint, size_t additionalBytes);
+    void chargeMemory(const std::string& sessionID, size_t bytes);
+    void releaseMemory(const std::string& sessionID, size_t bytes);
+    void touchNotification(const std::string& notificationID);
+    bool evictLeastRecentlyUsed(const std::string* sessionID, const std::string& protectedID);
+    void releaseNotification(const std::string& notificationID);
 
     std::optional<std::string> allocateNotificationID();
     void freeNotificationID(const std::string& notificationID);
@@ -0,0 +1,51 @@
+// Server-side notification templates.
+// A template is a title/message pair with positional placeholders, compiled once when a
+// session registers it: "{0} last {1}" renders parameter 0 and 1 in place, and "{{" / "}}"
+// stand for literal braces. Notifications created from a template store only the template
+// and their parameters; the text is rendered when it is displayed or queried.
+
+#ifndef NOTIFICATION_TEMPLATE_H
+#define NOTIFICATION_TEMPLATE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class NotificationTemplate {
+public:
+    static constexpr size_t MAX_PARAMETERS = 32;
+
+    // Throws std::runtime_error if either pattern is malformed.
+    NotificationTemplate(const std::string& title, const std::string& message);
+
+    std::string renderTitle(const std::vector<std::string>& parameters) const;
+    std::string renderMessage(const std::vector<std::string>& parameters) const;
+    // Length of the rendered text, without rendering it.
+    size_t getRenderedTitleLength(const std::vector<std::string>& parameters) const;
+    size_t getRenderedMessageLength(const std::vector<std::string>& parameters) const;
+
+    // Highest placeholder index + 1; notifications must supply exactly this many parameters.
+    size_t getParameterCount() const;
+    // Identifies the template text, so re-registering an ID with different text is not
+    // mistaken for the old template when deduplicating.
+    uint64_t getFingerprint() const;
+    // Bytes the compiled template holds, charged to the registering session's memory budget.
+    size_t getMemoryFootprint() const;
+
+private:
+    struct Segment {
+        std::string literal;
+        int parameter; // -1 if the segment is only literal text
+    };
+
+    std::vector<Segment> titleSegments;
+    std::vector<Segment> messageSegments;
+    size_t parameterCount = 0;
+    uint64_t fingerprint = 0;
+
+    std::vector<Segment> compile(const std::string& pattern);
+    static size_t renderedLength(const std::vector<Segment>& segments, const std::vector<std::string>& parameters);
+    static std::string render(const std::vector<Segment>& segments, const std::vector<std::string>& parameters);
+};
+
+#endif // NOTIFICATION_TEMPLATE_H
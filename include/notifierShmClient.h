@@ -0,0 +1,134 @@
+// Header-only producer client for the notifier's shared-memory ingest channel (Linux only).
+//
+//     NotifierShmClient client("/tmp/notifier-ingest.sock");
+//     client.create(42, "AAPL", "Last 189.20", 1);
+//     client.update(42, "", "Last 189.25");   // empty fields are left unchanged
+//     client.remove(42);
+//
+// Notifications are addressed by a producer-chosen 64-bit key instead of the
+// notificationID, since enqueueing does not wait for a reply. All calls return false
+// when the ring is full or the text does not fit in one slot; the caller decides
+// whether to retry or drop. Each client has a ring of its own with a single writer, so
+// a client must not be used by several threads at once.
+
+#ifndef NOTIFIER_SHM_CLIENT_H
+#define NOTIFIER_SHM_CLIENT_H
+
+#include "shmRing.h"
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+class NotifierShmClient {
+public:
+    explicit NotifierShmClient(const std::string& socketPath = "/tmp/notifier-ingest.sock") {
+        socketFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (socketFd < 0) {
+            throw std::runtime_error("Failed to create ingest socket");
+        }
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(address.sun_path)) {
+            ::close(socketFd);
+            throw std::runtime_error("Ingest socket path too long: " + socketPath);
+        }
+        std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+        if (::connect(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(socketFd);
+            throw std::runtime_error("Failed to connect to notifier ingest socket: " + socketPath);
+        }
+
+        // The notifier answers with our producer ID and ring size and passes our ring and its wakeup eventfd.
+        uint32_t handshake[2];
+        iovec data{ handshake, sizeof(handshake) };
+        alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))];
+        msghdr message{};
+        message.msg_iov = &data;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        cmsghdr* header = nullptr;
+        if (::recvmsg(socketFd, &message, MSG_CMSG_CLOEXEC) != sizeof(handshake) ||
+            !(header = CMSG_FIRSTHDR(&message)) || header->cmsg_type != SCM_RIGHTS ||
+            header->cmsg_len != CMSG_LEN(2 * sizeof(int))) {
+            ::close(socketFd);
+            throw std::runtime_error("Invalid handshake from notifier ingest socket");
+        }
+
+        int fds[2];
+        std::memcpy(fds, CMSG_DATA(header), sizeof(fds));
+        ringFd = fds[0];
+        wakeupFd = fds[1];
+        producerID = handshake[0];
+        mappedBytes = shmRingBytes(handshake[1]);
+
+        void* mapping = ::mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, ringFd, 0);
+        if (mapping == MAP_FAILED || !shmRingValid(static_cast<ShmRingHeader*>(mapping))) {
+            if (mapping != MAP_FAILED) {
+                ::munmap(mapping, mappedBytes);
+            }
+            closeDescriptors();
+            throw std::runtime_error("Failed to map notifier ingest ring");
+        }
+        ring = static_cast<ShmRingHeader*>(mapping);
+    }
+
+    ~NotifierShmClient() {
+        ::munmap(ring, mappedBytes);
+        closeDescriptors();
+    }
+
+    // priority: 0 = low, 1 = normal, 2 = high
+    bool create(uint64_t clientKey, std::string_view title, std::string_view message, uint8_t priority = 1) {
+        return push(ShmOp::Create, clientKey, title, message, priority);
+    }
+
+    bool update(uint64_t clientKey, std::string_view title, std::string_view message) {
+        return push(ShmOp::Update, clientKey, title, message, 1);
+    }
+
+    bool remove(uint64_t clientKey) {
+        return push(ShmOp::Remove, clientKey, {}, {}, 1);
+    }
+
+    uint32_t getProducerID() const {
+        return producerID;
+    }
+
+private:
+    int socketFd = -1;
+    int ringFd = -1;
+    int wakeupFd = -1;
+    uint32_t producerID = 0;
+    size_t mappedBytes = 0;
+    ShmRingHeader* ring = nullptr;
+
+    bool push(ShmOp op, uint64_t clientKey, std::string_view title, std::string_view message, uint8_t priority) {
+        ShmRecord record{};
+        record.op = op;
+        record.priority = priority;
+        record.clientKey = clientKey;
+        return shmRingPush(ring, wakeupFd, record, title, message);
+    }
+
+    void closeDescriptors() {
+        for (int fd : { ringFd, wakeupFd, socketFd }) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    NotifierShmClient(const NotifierShmClient&) = delete;
+    NotifierShmClient& operator=(const NotifierShmClient&) = delete;
+};
+
+#endif // NOTIFIER_SHM_CLIENT_H
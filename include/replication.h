@@ -0,0 +1,89 @@
+// Leader/follower replication of notification state.
+//
+// A leader (notifier --leader) serves its MutationLog on the "/replicate" WebSocket path.
+// A follower (notifier --follow host:port) subscribes with the last sequence it applied
+// and receives either the missing mutations or, if those are no longer retained, a
+// snapshot followed by the live stream. Followers apply everything on their own event
+// loop and display it like local notifications.
+//
+// Frames (JSON text):
+//     follower -> leader  {"action": "subscribe", "logID": ..., "fromSequence": n}
+//     leader -> follower  {"type": "snapshot", "logID": ..., "sequence": n, "notifications": [...]}
+//                         {"type": "mutation", "sequence": n, "op": "created", ...}
+//                         {"type": "heartbeat", "logID": ..., "sequence": n, "timestampMs": t}
+
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include "mutationLog.h"
+#include "notificationManager.h"
+#include <uwebsockets/App.h>
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+nlohmann::json mutationToJson(const Mutation& mutation);
+Mutation mutationFromJson(const nlohmann::json& json);
+
+struct ReplicationStatus {
+    bool connected = false;
+    uint64_t leaderSequence = 0;
+    uint64_t appliedSequence = 0;
+    int64_t lagMs = 0;
+    uint64_t snapshotsApplied = 0;
+};
+
+class ReplicationFollower {
+public:
+    ReplicationFollower(const std::string& host, int port, NotificationManager& manager, uWS::Loop* loop);
+    ~ReplicationFollower();
+
+    void start();
+    void stop();
+
+    ReplicationStatus getStatus() const;
+
+    // Called on the event loop when the local memory budget evicts a notification, so a
+    // replica that was evicted here stops mapping to a local ID that may be reused.
+    void handleLocalEviction(const std::string& sessionID, const std::string& notificationID);
+
+private:
+    static constexpr int RECONNECT_DELAY_MS = 1000;
+    static constexpr int LEADER_TIMEOUT_MS = 5000;
+
+    std::string host;
+    int port;
+    NotificationManager& notificationManager;
+    uWS::Loop* loop;
+
+    std::thread worker;
+    std::atomic<bool> running;
+
+    std::atomic<bool> connected;
+    std::atomic<uint64_t> leaderSequence;
+    std::atomic<uint64_t> appliedSequence;
+    std::atomic<int64_t> lagMs;
+    std::atomic<uint64_t> snapshotsApplied;
+
+    // Only touched on the event loop: leader notificationID -> local notificationID.
+    std::unordered_map<std::string, std::string> replicatedIDs;
+    // Only touched on the event loop: replica sessionID -> replicated notifications it holds.
+    // A replica session is removed once its last notification goes.
+    std::unordered_map<std::string, size_t> replicaSessionSizes;
+
+    void run();
+    void streamFromLeader(std::string& logID, uint64_t& nextSequence);
+
+    void applySnapshot(uint64_t sequence, std::vector<Mutation> snapshot);
+    void applyMutation(const Mutation& mutation);
+    std::string localSessionID(const std::string& leaderSessionID);
+    void releaseReplica(const std::string& sessionID);
+    void removeIfEmpty(const std::string& sessionID);
+
+    ReplicationFollower(const ReplicationFollower&) = delete;
+    ReplicationFollower& operator=(const ReplicationFollower&) = delete;
+};
+
+#endif // REPLICATION_H
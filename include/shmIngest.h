@@ -0,0 +1,103 @@
+// Server side of the shared-memory ingest channel (Linux only).
+//
+// Producers connect to a Unix socket and receive a ring of their own (a memfd) and the
+// consumer's wakeup eventfd; from then on they enqueue records straight into shared
+// memory (see shmRing.h and notifierShmClient.h). A drain thread empties the rings in
+// batches and hands each batch to the event loop, where it is applied to
+// NotificationManager. Records are attributed to the producer whose ring they came from,
+// so every producer can only touch its own "shm-<producerID>" session, which is removed
+// together with the ring when the producer's socket closes.
+
+#ifndef SHM_INGEST_H
+#define SHM_INGEST_H
+
+#include "shmRing.h"
+#include "notificationManager.h"
+#include <uwebsockets/App.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ShmIngestStats {
+    uint64_t recordsApplied = 0;
+    uint64_t batchesApplied = 0;
+    size_t producersConnected = 0;
+    uint32_t ringCapacity = 0;
+};
+
+class ShmIngest {
+public:
+    ShmIngest(const std::string& socketPath, uint32_t capacity, NotificationManager& manager, uWS::Loop* loop);
+    ~ShmIngest();
+
+    void start();
+    void stop();
+
+    ShmIngestStats getStats() const;
+
+    // Called on the event loop when the memory budget evicts a notification, so the
+    // producer's key stops mapping to a notificationID that may be reused.
+    void handleLocalEviction(const std::string& sessionID, const std::string& notificationID);
+
+private:
+    static constexpr size_t MAX_BATCH_SIZE = 1024;
+    static constexpr size_t MAX_PENDING_RECORDS = 64 * 1024;
+
+    struct IngestRecord {
+        uint32_t producerID;
+        ShmRecord record;
+        std::string title;
+        std::string message;
+    };
+
+    std::string socketPath;
+    uint32_t capacity;
+    NotificationManager& notificationManager;
+    uWS::Loop* loop;
+
+    // The server's view of one producer's ring. readPosition is kept here rather than
+    // read back from the mapping, which the producer can write to.
+    struct ProducerRing {
+        uint32_t producerID;
+        ShmRingHeader* ring;
+        uint64_t readPosition;
+    };
+
+    int listenFd = -1;
+    int wakeupFd = -1;
+
+    std::atomic<bool> running;
+    std::thread acceptThread;
+    std::thread drainThread;
+    std::atomic<size_t> pendingRecords;
+    std::atomic<uint64_t> recordsApplied;
+    std::atomic<uint64_t> batchesApplied;
+    std::atomic<size_t> producersConnected;
+
+    // Rings of new producers and IDs of producers that hung up, handed from the accept
+    // thread to the drain thread, which owns the rings from then on.
+    std::mutex handoffMutex;
+    std::vector<ProducerRing> arrivedRings;
+    std::vector<uint32_t> departedProducers;
+
+    // Only touched on the event loop.
+    std::set<uint32_t> activeProducers;
+    std::map<std::pair<uint32_t, uint64_t>, std::string> notificationIDs;
+
+    void acceptLoop();
+    void drainLoop();
+    void drainRing(ProducerRing& producerRing, std::vector<IngestRecord>& batch);
+    ShmRingHeader* createRing(int& ringFd);
+    void destroyRing(ShmRingHeader* ring);
+    void applyBatch(const std::vector<IngestRecord>& batch);
+    void removeProducer(uint32_t producerID);
+
+    ShmIngest(const ShmIngest&) = delete;
+    ShmIngest& operator=(const ShmIngest&) = delete;
+};
+
+#endif // SHM_INGEST_H
@@ -0,0 +1,147 @@
+// Shared-memory ring used for same-host ingest (Linux only).
+//
+// Every producer gets its own ring: a bounded single-producer/single-consumer queue of
+// fixed-size slots in one shared mapping. The producer fills the slot at writePosition
+// and publishes it by advancing writePosition; the consumer copies slots out in order
+// and hands them back by advancing readPosition. The consumer sleeps on an eventfd, and
+// producers only pay for a write() when the consumer has announced it is about to sleep.
+//
+// The producer can write anywhere in the mapping, so the consumer trusts none of it:
+// it uses its own capacity and read position, ignores a writePosition that claims more
+// than a full ring, and validates every record it copies out. A producer can only
+// garble its own records.
+//
+// This header is shared by the notifier and by producers (see notifierShmClient.h), so
+// it must stay self-contained and its layout must not change without bumping
+// SHM_RING_VERSION.
+
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <string_view>
+
+#include <unistd.h>
+
+constexpr uint64_t SHM_RING_MAGIC = 0x474E495246544E4EULL; // "NNTFRING"
+constexpr uint32_t SHM_RING_VERSION = 2;
+constexpr size_t SHM_SLOT_SIZE = 512;
+
+enum class ShmOp : uint8_t {
+    Create = 1,
+    Update = 2,
+    Remove = 3,
+};
+
+// Priority values match PriorityEnum's order: 0 = low, 1 = normal, 2 = high.
+struct ShmRecord {
+    ShmOp op;
+    uint8_t priority;
+    uint16_t titleLength;
+    uint16_t messageLength;
+    uint64_t clientKey;
+};
+
+struct ShmSlot {
+    ShmRecord record;
+    char text[SHM_SLOT_SIZE - sizeof(ShmRecord)];
+};
+
+constexpr size_t SHM_TEXT_CAPACITY = sizeof(ShmSlot::text);
+
+static_assert(sizeof(ShmSlot) == SHM_SLOT_SIZE, "ShmSlot must match SHM_SLOT_SIZE");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared-memory atomics must be lock free");
+
+struct ShmRingHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    alignas(64) std::atomic<uint64_t> writePosition;
+    alignas(64) std::atomic<uint64_t> readPosition;
+    alignas(64) std::atomic<uint32_t> consumerSleeping;
+    alignas(64) ShmSlot slots[1];
+};
+
+inline size_t shmRingBytes(uint32_t capacity) {
+    return offsetof(ShmRingHeader, slots) + static_cast<size_t>(capacity) * sizeof(ShmSlot);
+}
+
+// Initialises a zeroed mapping of shmRingBytes(capacity) bytes; capacity must be a power of two.
+inline void shmRingInit(ShmRingHeader* ring, uint32_t capacity) {
+    ring->capacity = capacity;
+    ring->writePosition.store(0, std::memory_order_relaxed);
+    ring->readPosition.store(0, std::memory_order_relaxed);
+    ring->consumerSleeping.store(0, std::memory_order_relaxed);
+    ring->version = SHM_RING_VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    ring->magic = SHM_RING_MAGIC;
+}
+
+inline bool shmRingValid(const ShmRingHeader* ring) {
+    return ring->magic == SHM_RING_MAGIC && ring->version == SHM_RING_VERSION;
+}
+
+// Producer side; only one thread may push to a ring. Returns false if the ring is full
+// or the text does not fit in one slot.
+inline bool shmRingPush(ShmRingHeader* ring, int wakeupFd, const ShmRecord& record,
+    std::string_view title, std::string_view message) {
+    if (title.size() + message.size() > SHM_TEXT_CAPACITY) {
+        return false;
+    }
+
+    uint64_t position = ring->writePosition.load(std::memory_order_relaxed);
+    if (position - ring->readPosition.load(std::memory_order_acquire) >= ring->capacity) {
+        return false;
+    }
+
+    ShmSlot* slot = &ring->slots[position & (ring->capacity - 1)];
+    slot->record = record;
+    slot->record.titleLength = static_cast<uint16_t>(title.size());
+    slot->record.messageLength = static_cast<uint16_t>(message.size());
+    std::memcpy(slot->text, title.data(), title.size());
+    std::memcpy(slot->text + title.size(), message.data(), message.size());
+    ring->writePosition.store(position + 1, std::memory_order_release);
+
+    // Pairs with the fence in shmRingPrepareSleep: either the consumer sees this slot
+    // when it re-checks, or we see its sleeping flag here.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring->consumerSleeping.load(std::memory_order_relaxed) && ring->consumerSleeping.exchange(0) && wakeupFd >= 0) {
+        uint64_t one = 1;
+        [[maybe_unused]] auto written = ::write(wakeupFd, &one, sizeof(one));
+    }
+    return true;
+}
+
+// Consumer side. `readPosition` and `capacity` are the consumer's own copies, never
+// read back from the mapping. Returns how many published slots follow readPosition; a
+// producer that reports more than a full ring has corrupted it and gets nothing read.
+inline uint64_t shmRingAvailable(const ShmRingHeader* ring, uint64_t readPosition, uint32_t capacity) {
+    uint64_t available = ring->writePosition.load(std::memory_order_acquire) - readPosition;
+    return available <= capacity ? available : 0;
+}
+
+inline const ShmSlot* shmRingSlot(const ShmRingHeader* ring, uint64_t position, uint32_t capacity) {
+    return &ring->slots[position & (capacity - 1)];
+}
+
+// Hands every slot before readPosition back to the producer, once they have been copied out.
+inline void shmRingRelease(ShmRingHeader* ring, uint64_t readPosition) {
+    ring->readPosition.store(readPosition, std::memory_order_release);
+}
+
+// Announces that the consumer is about to block on the eventfd. Returns false (and
+// withdraws the announcement) if a record arrived in the meantime.
+inline bool shmRingPrepareSleep(ShmRingHeader* ring, uint64_t readPosition, uint32_t capacity) {
+    ring->consumerSleeping.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (shmRingAvailable(ring, readPosition, capacity)) {
+        ring->consumerSleeping.store(0, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+#endif // SHM_RING_H
@@ -8,41 +8,83 @@
 
 class TerminalUI {
 public:
+    static inline int port = 9001;
+
     static void displayIntro() {
         std::cout << std::string(80, '=') << "\n";
         std::cout << "              Thanks for using the Lightweight Notifier  \n";
         std::cout << "       Bridging Client Scripts with Windows Toast Notifications API\n";
         std::cout << std::string(80, '=') << "\n\n";
 
-        std::cout << "Server is listening on port 9001\n";
-        std::cout << "To start, open a WebSocket connection at: ws://localhost:9001\n";
+        std::cout << "Server is listening on port " << port << "\n";
+        std::cout << "To start, open a WebSocket connection at: ws://localhost:" << port << "\n";
         std::cout << "Press Ctrl + C twice to close all connections.\n";
     }
 
+    // Holds back redraws while a batch of changes is applied; the screen is redrawn once
+    // when the outermost DeferredRefresh goes out of scope, if anything asked for it.
+    class DeferredRefresh {
+    public:
+        DeferredRefresh() { ++deferDepth; }
+        ~DeferredRefresh() {
+            if (--deferDepth == 0 && refreshPending) {
+                refreshPending = false;
+                refreshScreen();
+            }
+        }
+        DeferredRefresh(const DeferredRefresh&) = delete;
+        DeferredRefresh& operator=(const DeferredRefresh&) = delete;
+    };
+
     static void refreshScreen() {
+        if (deferDepth) {
+            refreshPending = true;
+            return;
+        }
         std::cout << "\033[2J\033[H"; 
 
         std::cout << std::string(80, '=') << "\n";
         std::cout << "        Lightweight Notifier - Active Sessions & Notifications\n";
         std::cout << std::string(80, '=') << "\n";
-        std::cout << "Server is running on port 9001\n";
-        std::cout << "WebSocket Endpoint: ws://localhost:9001\n";
+        std::cout << "Server is running on port " << port << "\n";
+        std::cout << "WebSocket Endpoint: ws://localhost:" << port << "\n";
         std::cout << "Press Ctrl + C twice to exit the program.\n";
         std::cout << "-----------------------------------------\n";
 
         std::set<std::string> activeSessions = NotificationManager::getInstance().getActiveSessions();
+        MemoryStats memory = NotificationManager::getInstance().getMemoryStats();
         std::cout << "\n[ACTIVE SESSIONS]: ";
         if (activeSessions.empty()) {
             std::cout << "No active sessions.\n";
         }
         else {
             for (const auto& sessionID : activeSessions) {
-                std::cout << "\n session " << sessionID << " ";
+                std::cout << "\n session " << sessionID << " (" << memory.sessionBytes[sessionID] << " bytes)";
             }
             std::cout << "\n";
         }
 
-        std::cout << "-----------------------------------------\n\n";
+        std::cout << "-----------------------------------------\n";
+
+        std::cout << "[MEMORY]: used " << memory.totalBytes << " bytes";
+        if (memory.globalBudget) {
+            std::cout << " / budget " << memory.globalBudget;
+        }
+        std::cout << " | evictions " << memory.evictions << "\n";
+        std::cout << "-----------------------------------------\n";
+
+        if (auto dedup = NotificationManager::getInstance().getDedupStats()) {
+            std::cout << "[DEDUP]: hits " << dedup->hits << " | misses " << dedup->misses
+                << " | entries " << dedup->entries << "/" << dedup->capacity
+                << " | memory " << dedup->memoryBytes << " bytes\n";
+            std::cout << "-----------------------------------------\n";
+        }
+        if (auto digest = NotificationManager::getInstance().getDigestStats()) {
+            std::cout << "[DIGEST]: pending " << digest->pendingNotifications << " | digested " << digest->notificationsDigested
+                << " | delivered " << digest->digestsDelivered << " | toasts saved " << digest->deliveriesSaved << "\n";
+            std::cout << "-----------------------------------------\n";
+        }
+        std::cout << "\n";
 
         auto activeNotifications = NotificationManager::getInstance().getActiveNotifications();
         if (activeNotifications.empty()) {
@@ -64,6 +106,10 @@ public:
         }
         std::cout << "\n";
     }
+
+private:
+    static inline int deferDepth = 0;
+    static inline bool refreshPending = false;
 };
 
 #endif // TERMINAL_UI_H
@@ -0,0 +1,72 @@
+// Records inbound WebSocket traffic to a compact binary file so a production
+// traffic pattern can be replayed later with notifier_replay.
+//
+// File layout (all integers little-endian):
+//     8 bytes   magic "NTFCAP01"
+//     records   u64 timestamp (ns since capture start, monotonic clock)
+//               u32 connection ID
+//               u8  record kind (CaptureKind)
+//               u32 payload length
+//               payload bytes
+
+#ifndef TRAFFIC_CAPTURE_H
+#define TRAFFIC_CAPTURE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+
+enum class CaptureKind : uint8_t {
+    Open = 0,
+    Text = 1,
+    Binary = 2,
+    Close = 3,
+};
+
+struct CaptureRecord {
+    uint64_t timestampNs = 0;
+    uint32_t connectionID = 0;
+    CaptureKind kind = CaptureKind::Open;
+    std::string payload;
+};
+
+class TrafficCapture {
+public:
+    explicit TrafficCapture(const std::string& path);
+    ~TrafficCapture();
+
+    void record(uint32_t connectionID, CaptureKind kind, std::string_view payload = {});
+    void flush();
+
+    uint64_t getRecordCount() const;
+
+private:
+    static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+    std::FILE* file;
+    std::vector<char> buffer;
+    std::chrono::steady_clock::time_point startTime;
+    uint64_t recordCount = 0;
+
+    TrafficCapture(const TrafficCapture&) = delete;
+    TrafficCapture& operator=(const TrafficCapture&) = delete;
+};
+
+class CaptureReader {
+public:
+    explicit CaptureReader(const std::string& path);
+    ~CaptureReader();
+
+    bool next(CaptureRecord& record);
+
+private:
+    std::FILE* file;
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+};
+
+#endif // TRAFFIC_CAPTURE_H
@@ -0,0 +1,53 @@
+// Minimal blocking WebSocket client (RFC 6455, no TLS, no extensions).
+// Used by the replay and benchmark tools to talk to a running notifier.
+
+#ifndef WEBSOCKET_CLIENT_H
+#define WEBSOCKET_CLIENT_H
+
+#include <string>
+#include <string_view>
+#include <random>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <winsock2.h>
+using SocketHandle = SOCKET;
+#else
+using SocketHandle = int;
+#endif
+
+class WebSocketClient {
+public:
+    WebSocketClient();
+    ~WebSocketClient();
+
+    void connect(const std::string& host, int port, const std::string& path = "/");
+    void close();
+    bool isOpen() const;
+
+    void sendText(std::string_view message);
+    void sendBinary(std::string_view message);
+
+    // Returns true once a complete text/binary message is available, false if none
+    // arrived within timeoutMs. Throws std::runtime_error once the connection is closed.
+    bool receive(std::string& message, int timeoutMs);
+
+    SocketHandle getHandle() const;
+
+private:
+    SocketHandle socketHandle;
+    std::string readBuffer;
+    std::string fragmentBuffer;
+    std::mt19937 maskGenerator;
+
+    void sendFrame(uint8_t opCode, std::string_view payload);
+    void sendAll(const char* data, size_t length);
+    bool waitReadable(int timeoutMs);
+    void readMore();
+    bool parseFrame(std::string& message);
+
+    WebSocketClient(const WebSocketClient&) = delete;
+    WebSocketClient& operator=(const WebSocketClient&) = delete;
+};
+
+#endif // WEBSOCKET_CLIENT_H
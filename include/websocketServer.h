@@ -2,32 +2,82 @@
 #define WEBSOCKETSERVER_H
 
 #include "notificationManager.h"
+#include "trafficCapture.h"
+#include "replication.h"
+#ifdef __linux__
+#include "shmIngest.h"
+#endif
 #include <uwebsockets/App.h>
 #include <nlohmann/json.hpp>
 #include <string>
 #include <unordered_map>
 #include <bitset>
 #include <atomic>
+#include <memory>
+#include <set>
 
 struct UserData {
     std::string sessionID;
+    uint32_t connectionID;
+    // Set when a watching connection fell behind and is owed a fresh snapshot.
+    bool resyncPending = false;
+};
+
+struct FollowerData {
+    bool subscribed = false;
 };
 
 class WebSocketServer {
 public:
-    WebSocketServer(NotificationManager& manager);
+    WebSocketServer(NotificationManager& manager, int port = 9001);
     ~WebSocketServer();
 
     void run();
     void stop();
+    void enableCapture(const std::string& path);
+    void enableLeader();
+    void enableFollower(const std::string& leaderHost, int leaderPort);
+#ifdef __linux__
+    void enableShmIngest(const std::string& socketPath);
+#endif
 
 private:
+    static constexpr int TICK_INTERVAL_MS = 1000;
+    static constexpr unsigned int MAX_FOLLOWER_BACKLOG = 16 * 1024 * 1024;
+    static constexpr uint32_t SHM_RING_CAPACITY = 8 * 1024; // slots per producer, 4 MiB each
+    static constexpr unsigned int MAX_CLIENT_BACKPRESSURE = 16 * 1024 * 1024;
+    static constexpr unsigned int MAX_WATCHER_BACKLOG = 1024 * 1024;
+
     int port;
     std::atomic<bool> keepRunning;
     NotificationManager& notificationManager;
 
     std::unordered_map<std::string, uWS::WebSocket<false, true, UserData>*> activeConnections;
     std::bitset<32> usedIDs;
+    uint32_t nextConnectionID = 0;
+    std::unique_ptr<TrafficCapture> capture;
+    size_t mutationSubscription;
+    std::set<uWS::WebSocket<false, true, UserData>*> watchers;
+    uint64_t watcherResyncs = 0;
+
+    // Event loop time spent on client requests, split at the end of JSON parsing; the
+    // handle part covers everything after it up to and including sending the response.
+    struct RequestTiming {
+        uint64_t handled = 0;
+        uint64_t parseNanoseconds = 0;
+        uint64_t handleNanoseconds = 0;
+    } requestTiming;
+
+    bool leaderEnabled = false;
+    std::set<uWS::WebSocket<false, true, FollowerData>*> followers;
+    std::string leaderHost;
+    int leaderPort = 0;
+    std::unique_ptr<ReplicationFollower> follower;
+
+#ifdef __linux__
+    std::string shmSocketPath;
+    std::unique_ptr<ShmIngest> shmIngest;
+#endif
 
     std::string generateSessionID();
     void freeSessionID(const std::string& sessionID);
@@ -35,6 +85,15 @@ private:
     void handleConnectionOpen(uWS::WebSocket<false, true, UserData>* ws);
     void handleConnectionClose(uWS::WebSocket<false, true, UserData>* ws, int code, std::string_view message);
     void handleMessage(const std::string& message, uWS::WebSocket<false, true, UserData>* ws);
+    void handleEviction(const std::string& sessionID, const std::string& notificationID);
+    void handleTimerTick();
+    void handleMutation(const Mutation& mutation);
+    void handleFollowerSubscribe(uWS::WebSocket<false, true, FollowerData>* ws, std::string_view message);
+    void sendToFollowers(const std::string& frame);
+    nlohmann::json buildWatchSnapshot() const;
+    void sendToWatchers(const std::string& frame);
+    void resyncWatchers();
+    void updateMutationRecording();
 };
 
 #endif // WEBSOCKETSERVER_H
@@ -0,0 +1,214 @@
+#include "dedupCache.h"
+#include <cctype>
+
+namespace {
+    constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+    constexpr unsigned char FIELD_SEPARATOR = 0x1F;
+
+    // Hashes text with leading/trailing whitespace trimmed and inner whitespace runs collapsed,
+    // so "Price  dropped " and "Price dropped" count as the same notification.
+    uint64_t hashNormalized(uint64_t hash, const std::string& text) {
+        bool pendingSpace = false;
+        bool seenContent = false;
+        for (unsigned char c : text) {
+            if (std::isspace(c)) {
+                pendingSpace = seenContent;
+                continue;
+            }
+            if (pendingSpace) {
+                hash = (hash ^ ' ') * FNV_PRIME;
+                pendingSpace = false;
+            }
+            hash = (hash ^ c) * FNV_PRIME;
+            seenContent = true;
+        }
+        return (hash ^ FIELD_SEPARATOR) * FNV_PRIME;
+    }
+
+    uint64_t hashExact(uint64_t hash, const std::string& text) {
+        for (unsigned char c : text) {
+            hash = (hash ^ c) * FNV_PRIME;
+        }
+        return (hash ^ FIELD_SEPARATOR) * FNV_PRIME;
+    }
+
+    size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+DedupCache::DedupCache(size_t capacity, Clock::duration window)
+    : slots(roundUpToPowerOfTwo(capacity < 8 ? 8 : capacity)), window(window) {
+    mask = slots.size() - 1;
+    stats.capacity = slots.size();
+    hashByNotification.reserve(slots.size());
+}
+
+uint64_t DedupCache::hashContent(const std::string& sessionID, const std::string& title, const std::string& message,
+    const std::string& idempotencyKey) {
+    uint64_t hash = hashExact(FNV_OFFSET, sessionID);
+    hash = hashNormalized(hash, title);
+    hash = hashNormalized(hash, message);
+    for (unsigned char c : idempotencyKey) {
+        hash = (hash ^ c) * FNV_PRIME;
+    }
+    return hash;
+}
+
+uint64_t DedupCache::hashTemplate(const std::string& sessionID, uint64_t templateFingerprint, const std::vector<std::string>& parameters,
+    const std::string& idempotencyKey) {
+    uint64_t hash = hashExact(FNV_OFFSET, sessionID);
+    for (int shift = 0; shift < 64; shift += 8) {
+        hash = (hash ^ ((templateFingerprint >> shift) & 0xFF)) * FNV_PRIME;
+    }
+    hash = (hash ^ FIELD_SEPARATOR) * FNV_PRIME;
+    for (const auto& parameter : parameters) {
+        hash = hashNormalized(hash, parameter);
+    }
+    for (unsigned char c : idempotencyKey) {
+        hash = (hash ^ c) * FNV_PRIME;
+    }
+    return hash;
+}
+
+std::optional<std::string> DedupCache::lookup(uint64_t hash, Clock::time_point now) {
+    size_t index = findSlot(hash);
+    if (index == slots.size()) {
+        ++stats.misses;
+        return std::nullopt;
+    }
+
+    Slot& slot = slots[index];
+    if (now - slot.insertedAt > window) {
+        eraseAt(index);
+        ++stats.misses;
+        return std::nullopt;
+    }
+
+    slot.lastUsed = ++tick;
+    ++stats.hits;
+    return slot.notificationID;
+}
+
+void DedupCache::insert(uint64_t hash, const std::string& notificationID, Clock::time_point now) {
+    size_t existing = findSlot(hash);
+    if (existing != slots.size()) {
+        eraseAt(existing);
+    }
+
+    // Keep the load factor at or below 3/4 so probe sequences stay short.
+    if ((entries + 1) * 4 > slots.size() * 3) {
+        purgeExpired(now);
+    }
+    if ((entries + 1) * 4 > slots.size() * 3) {
+        evictLeastRecentlyUsed();
+    }
+
+    size_t index = hash & mask;
+    while (slots[index].occupied) {
+        index = (index + 1) & mask;
+    }
+
+    Slot& slot = slots[index];
+    slot.occupied = true;
+    slot.hash = hash;
+    slot.lastUsed = ++tick;
+    slot.insertedAt = now;
+    slot.notificationID = notificationID;
+    hashByNotification[notificationID] = hash;
+    ++entries;
+}
+
+void DedupCache::invalidate(const std::string& notificationID) {
+    auto it = hashByNotification.find(notificationID);
+    if (it == hashByNotification.end()) {
+        return;
+    }
+    size_t index = findSlot(it->second);
+    if (index != slots.size() && slots[index].notificationID == notificationID) {
+        eraseAt(index);
+    }
+    else {
+        hashByNotification.erase(it);
+    }
+}
+
+void DedupCache::clear() {
+    for (auto& slot : slots) {
+        slot = Slot{};
+    }
+    hashByNotification.clear();
+    entries = 0;
+}
+
+DedupStats DedupCache::getStats() const {
+    DedupStats result = stats;
+    result.entries = entries;
+    result.memoryBytes = sizeof(*this) + slots.capacity() * sizeof(Slot)
+        + hashByNotification.bucket_count() * sizeof(void*) + hashByNotification.size() * (sizeof(std::string) + sizeof(uint64_t) + 2 * sizeof(void*));
+    return result;
+}
+
+size_t DedupCache::findSlot(uint64_t hash) const {
+    size_t index = hash & mask;
+    while (slots[index].occupied) {
+        if (slots[index].hash == hash) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    return slots.size();
+}
+
+// Backward-shift deletion: pull later members of the probe chain into the hole
+// so lookups never need tombstones.
+void DedupCache::eraseAt(size_t index) {
+    if (auto it = hashByNotification.find(slots[index].notificationID); it != hashByNotification.end() && it->second == slots[index].hash) {
+        hashByNotification.erase(it);
+    }
+    slots[index] = Slot{};
+    --entries;
+
+    size_t hole = index;
+    size_t next = (index + 1) & mask;
+    while (slots[next].occupied) {
+        size_t home = slots[next].hash & mask;
+        bool homeBetween = (hole <= next) ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!homeBetween) {
+            slots[hole] = std::move(slots[next]);
+            slots[next] = Slot{};
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
+void DedupCache::purgeExpired(Clock::time_point now) {
+    size_t i = 0;
+    while (i < slots.size()) {
+        if (slots[i].occupied && now - slots[i].insertedAt > window) {
+            eraseAt(i);
+            ++stats.evictions;
+            continue; // a shifted entry may now occupy slot i
+        }
+        ++i;
+    }
+}
+
+void DedupCache::evictLeastRecentlyUsed() {
+    size_t victim = slots.size();
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].occupied && (victim == slots.size() || slots[i].lastUsed < slots[victim].lastUsed)) {
+            victim = i;
+        }
+    }
+    if (victim != slots.size()) {
+        eraseAt(victim);
+        ++stats.evictions;
+    }
+}
@@ -0,0 +1,388 @@
+#include "linux_api.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <dbus/dbus.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+    constexpr const char* NOTIFICATIONS_SERVICE = "org.freedesktop.Notifications";
+    constexpr const char* NOTIFICATIONS_PATH = "/org/freedesktop/Notifications";
+    constexpr const char* NOTIFICATIONS_INTERFACE = "org.freedesktop.Notifications";
+    constexpr const char* APP_NAME = "Lightweight Notifier";
+    constexpr auto RECONNECT_INTERVAL = std::chrono::seconds(5);
+    // No timeout functions are installed on the connection, so libdbus never expires a
+    // pending call by itself; the worker gives up on unanswered Notify calls after this.
+    constexpr auto NOTIFY_TIMEOUT = std::chrono::seconds(10);
+
+    struct DisplayRequest {
+        bool close;
+        std::string key;
+        std::string title;
+        std::string message;
+    };
+
+    // What we know about one of our notifications on the notification server.
+    struct DisplayedNotification {
+        uint32_t serverID = 0;
+        bool inFlight = false;
+        bool closeRequested = false;
+        DBusPendingCall* pending = nullptr;
+        std::chrono::steady_clock::time_point sentAt;
+        // Latest content that arrived while a Notify call was still waiting for its reply.
+        std::optional<std::pair<std::string, std::string>> queued;
+    };
+
+    // libdbus refuses strings that are not valid UTF-8, so anything else is reduced to ASCII.
+    std::string toValidUtf8(const std::string& text) {
+        if (dbus_validate_utf8(text.c_str(), nullptr)) {
+            return text;
+        }
+        std::string result;
+        for (char c : text) {
+            result += (static_cast<unsigned char>(c) < 0x80 && c != '\0') ? c : '?';
+        }
+        return result;
+    }
+
+    // While there is no connection every server ID is forgotten, so a close is a no-op and
+    // only the newest content per key still matters. Keeps the retained queue bounded by
+    // the number of keys.
+    void coalesceWhileDisconnected(std::vector<DisplayRequest>& requests) {
+        std::vector<DisplayRequest> kept;
+        std::unordered_map<std::string, bool> seen;
+        for (auto it = requests.rbegin(); it != requests.rend(); ++it) {
+            if (seen.emplace(it->key, true).second && !it->close) {
+                kept.push_back(std::move(*it));
+            }
+        }
+        requests.assign(std::make_move_iterator(kept.rbegin()), std::make_move_iterator(kept.rend()));
+    }
+
+    class DBusNotifier {
+    public:
+        static DBusNotifier& getInstance() {
+            static DBusNotifier instance;
+            return instance;
+        }
+
+        void enqueue(DisplayRequest request) {
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                queue.push_back(std::move(request));
+            }
+            wake();
+        }
+
+        void shutdown() {
+            if (!running.exchange(false)) {
+                return;
+            }
+            wake();
+            if (worker.joinable()) {
+                worker.join();
+            }
+            disconnect();
+            ::close(wakeupFd);
+        }
+
+    private:
+        struct PendingNotify {
+            DBusNotifier* notifier;
+            std::string key;
+        };
+
+        std::mutex queueMutex;
+        std::vector<DisplayRequest> queue;
+        int wakeupFd;
+        std::atomic<bool> running;
+        std::thread worker;
+
+        // Only touched by the worker thread.
+        DBusConnection* connection = nullptr;
+        std::chrono::steady_clock::time_point lastConnectAttempt;
+        std::unordered_map<std::string, DisplayedNotification> displayed;
+
+        DBusNotifier()
+            : wakeupFd(::eventfd(0, EFD_CLOEXEC)), running(true) {
+            worker = std::thread([this]() { run(); });
+        }
+
+        ~DBusNotifier() {
+            shutdown();
+        }
+
+        void wake() {
+            uint64_t one = 1;
+            [[maybe_unused]] auto written = ::write(wakeupFd, &one, sizeof(one));
+        }
+
+        void run() {
+            while (running) {
+                int busFd = -1;
+                if (connection) {
+                    dbus_connection_get_unix_fd(connection, &busFd);
+                }
+                pollfd descriptors[2] = { { wakeupFd, POLLIN, 0 }, { busFd, POLLIN, 0 } };
+                ::poll(descriptors, 2, 1000);
+
+                if (descriptors[0].revents & POLLIN) {
+                    uint64_t count;
+                    [[maybe_unused]] auto bytesRead = ::read(wakeupFd, &count, sizeof(count));
+                }
+
+                processQueue();
+            }
+            // Requests queued before shutdown still go out; their replies are not awaited.
+            processQueue();
+        }
+
+        void processQueue() {
+            std::vector<DisplayRequest> batch;
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                batch.swap(queue);
+            }
+            if (!batch.empty() && !ensureConnected()) {
+                // Kept for the next connection attempt, ahead of anything queued since.
+                std::lock_guard<std::mutex> lock(queueMutex);
+                batch.insert(batch.end(), std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.end()));
+                coalesceWhileDisconnected(batch);
+                queue.swap(batch);
+                return;
+            }
+            for (const auto& request : batch) {
+                apply(request);
+            }
+
+            if (connection) {
+                expireStalledCalls();
+                // One write for everything queued above, then collect whatever replies
+                // have arrived; replies may trigger follow-up calls, so flush again.
+                dbus_connection_flush(connection);
+                dbus_connection_read_write(connection, 0);
+                while (dbus_connection_dispatch(connection) == DBUS_DISPATCH_DATA_REMAINS) {
+                }
+                dbus_connection_flush(connection);
+
+                if (!dbus_connection_get_is_connected(connection)) {
+                    std::cerr << "[WARNING] Lost connection to the session bus." << std::endl;
+                    disconnect();
+                }
+            }
+        }
+
+        bool ensureConnected() {
+            if (connection) {
+                return true;
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (lastConnectAttempt != std::chrono::steady_clock::time_point() && now - lastConnectAttempt < RECONNECT_INTERVAL) {
+                return false;
+            }
+            lastConnectAttempt = now;
+
+            DBusError error;
+            dbus_error_init(&error);
+            connection = dbus_bus_get_private(DBUS_BUS_SESSION, &error);
+            if (!connection) {
+                std::cerr << "[ERROR] Could not connect to the session bus, notifications are not shown: "
+                    << (dbus_error_is_set(&error) ? error.message : "unknown error") << std::endl;
+                dbus_error_free(&error);
+                return false;
+            }
+            dbus_connection_set_exit_on_disconnect(connection, FALSE);
+            return true;
+        }
+
+        void disconnect() {
+            for (auto& [key, state] : displayed) {
+                releasePending(state, true);
+            }
+            if (connection) {
+                dbus_connection_close(connection);
+                dbus_connection_unref(connection);
+                connection = nullptr;
+            }
+            // Server IDs are meaningless on a new connection's notification server.
+            displayed.clear();
+        }
+
+        void apply(const DisplayRequest& request) {
+            if (request.close) {
+                auto it = displayed.find(request.key);
+                if (it == displayed.end()) {
+                    return;
+                }
+                if (it->second.inFlight) {
+                    it->second.closeRequested = true;
+                    it->second.queued.reset();
+                    return;
+                }
+                sendClose(it->second.serverID);
+                displayed.erase(it);
+                return;
+            }
+
+            DisplayedNotification& state = displayed[request.key];
+            if (state.inFlight) {
+                // Only the newest content matters; it goes out with the server ID once the
+                // pending Notify call has told us what that ID is.
+                state.queued.emplace(request.title, request.message);
+                state.closeRequested = false;
+                return;
+            }
+            sendNotify(request.key, state, request.title, request.message);
+        }
+
+        void sendNotify(const std::string& key, DisplayedNotification& state, const std::string& title, const std::string& message) {
+            DBusMessage* call = dbus_message_new_method_call(NOTIFICATIONS_SERVICE, NOTIFICATIONS_PATH, NOTIFICATIONS_INTERFACE, "Notify");
+            if (!call) {
+                return;
+            }
+
+            std::string summary = toValidUtf8(title);
+            std::string body = toValidUtf8(message);
+            const char* appName = APP_NAME;
+            const char* appIcon = "";
+            const char* summaryText = summary.c_str();
+            const char* bodyText = body.c_str();
+            dbus_uint32_t replacesID = state.serverID;
+            dbus_int32_t expireTimeout = -1;
+
+            DBusMessageIter arguments, actions, hints;
+            dbus_message_iter_init_append(call, &arguments);
+            dbus_message_iter_append_basic(&arguments, DBUS_TYPE_STRING, &appName);
+            dbus_message_iter_append_basic(&arguments, DBUS_TYPE_UINT32, &replacesID);
+            dbus_message_iter_append_basic(&arguments, DBUS_TYPE_STRING, &appIcon);
+            dbus_message_iter_append_basic(&arguments, DBUS_TYPE_STRING, &summaryText);
+            dbus_message_iter_append_basic(&arguments, DBUS_TYPE_STRING, &bodyText);
+            dbus_message_iter_open_container(&arguments, DBUS_TYPE_ARRAY, DBUS_TYPE_STRING_AS_STRING, &actions);
+            dbus_message_iter_close_container(&arguments, &actions);
+            dbus_message_iter_open_container(&arguments, DBUS_TYPE_ARRAY, "{sv}", &hints);
+            dbus_message_iter_close_container(&arguments, &hints);
+            dbus_message_iter_append_basic(&arguments, DBUS_TYPE_INT32, &expireTimeout);
+
+            DBusPendingCall* pending = nullptr;
+            int timeoutMs = static_cast<int>(std::chrono::milliseconds(NOTIFY_TIMEOUT).count());
+            if (!dbus_connection_send_with_reply(connection, call, &pending, timeoutMs) || !pending) {
+                std::cerr << "[ERROR] Failed to send notification to the session bus." << std::endl;
+                dbus_message_unref(call);
+                return;
+            }
+            dbus_pending_call_set_notify(pending, &DBusNotifier::onNotifyReply, new PendingNotify{ this, key },
+                [](void* data) { delete static_cast<PendingNotify*>(data); });
+            dbus_message_unref(call);
+            // Our reference lets a call that is never answered be cancelled.
+            state.pending = pending;
+            state.sentAt = std::chrono::steady_clock::now();
+            state.inFlight = true;
+        }
+
+        void releasePending(DisplayedNotification& state, bool cancel) {
+            if (!state.pending) {
+                return;
+            }
+            if (cancel) {
+                dbus_pending_call_cancel(state.pending);
+            }
+            dbus_pending_call_unref(state.pending);
+            state.pending = nullptr;
+        }
+
+        // Treats Notify calls that have waited longer than NOTIFY_TIMEOUT as failed, so a
+        // notification server that never answers cannot hold back later updates and
+        // closes for those keys forever.
+        void expireStalledCalls() {
+            auto now = std::chrono::steady_clock::now();
+            std::vector<std::string> stalled;
+            for (const auto& [key, state] : displayed) {
+                if (state.inFlight && now - state.sentAt >= NOTIFY_TIMEOUT) {
+                    stalled.push_back(key);
+                }
+            }
+            for (const auto& key : stalled) {
+                releasePending(displayed[key], true);
+                handleNotifyReply(key, nullptr);
+            }
+        }
+
+        void sendClose(uint32_t serverID) {
+            if (serverID == 0) {
+                return;
+            }
+            DBusMessage* call = dbus_message_new_method_call(NOTIFICATIONS_SERVICE, NOTIFICATIONS_PATH, NOTIFICATIONS_INTERFACE, "CloseNotification");
+            if (!call) {
+                return;
+            }
+            dbus_uint32_t id = serverID;
+            dbus_message_append_args(call, DBUS_TYPE_UINT32, &id, DBUS_TYPE_INVALID);
+            dbus_message_set_no_reply(call, TRUE);
+            dbus_connection_send(connection, call, nullptr);
+            dbus_message_unref(call);
+        }
+
+        static void onNotifyReply(DBusPendingCall* pending, void* data) {
+            auto* context = static_cast<PendingNotify*>(data);
+            DBusMessage* reply = dbus_pending_call_steal_reply(pending);
+            context->notifier->handleNotifyReply(context->key, reply);
+            if (reply) {
+                dbus_message_unref(reply);
+            }
+        }
+
+        void handleNotifyReply(const std::string& key, DBusMessage* reply) {
+            auto it = displayed.find(key);
+            if (it == displayed.end()) {
+                return;
+            }
+            DisplayedNotification& state = it->second;
+            state.inFlight = false;
+            // libdbus holds its own reference while this reply is being delivered.
+            releasePending(state, false);
+
+            dbus_uint32_t serverID = 0;
+            if (reply && dbus_message_get_type(reply) == DBUS_MESSAGE_TYPE_METHOD_RETURN &&
+                dbus_message_get_args(reply, nullptr, DBUS_TYPE_UINT32, &serverID, DBUS_TYPE_INVALID)) {
+                state.serverID = serverID;
+            }
+            else {
+                std::cerr << "[ERROR] Notification server rejected notification: "
+                    << (reply && dbus_message_get_error_name(reply) ? dbus_message_get_error_name(reply) : "no reply in time") << std::endl;
+            }
+
+            if (state.closeRequested) {
+                sendClose(state.serverID);
+                displayed.erase(it);
+                return;
+            }
+            if (state.queued) {
+                auto [title, message] = std::move(*state.queued);
+                state.queued.reset();
+                sendNotify(key, state, title, message);
+            }
+        }
+    };
+}
+
+void LinuxAPI::showNotification(const std::string& key, const std::string& title, const std::string& message) {
+    DBusNotifier::getInstance().enqueue({ false, key, title, message });
+}
+
+void LinuxAPI::closeNotification(const std::string& key) {
+    DBusNotifier::getInstance().enqueue({ true, key, "", "" });
+}
+
+void LinuxAPI::cleanup() {
+    DBusNotifier::getInstance().shutdown();
+    std::cout << "LinuxAPI cleanup completed." << std::endl;
+}
@@ -1,10 +1,13 @@
 #include "websocketServer.h"
 #include "notificationManager.h"
 #include "terminalUI.h"
+#include "notificationBackend.h"
 #include <iostream>
 #include <thread>
 #include <csignal>
 #include <future>
+#include <string>
+#include <stdexcept>
 
 std::atomic<bool> keepRunning(true);
 std::atomic<bool> terminateProgramme(false);
@@ -20,12 +23,123 @@ static void signalHandler(int signal) {
     }
 }
 
-int main() {
+static void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [--port <port>] [--capture <file>] [--memory-budget <bytes>] [--session-budget <bytes>]\n"
+        << "       [--dedup-window <seconds>] [--digest-interval <seconds>] [--digest-size <count>]\n"
+        << "       [--leader | --follow <host:port>] [--shm-ingest <socket>]\n"
+        << "  --port <port>             Port to listen on (default 9001)\n"
+        << "  --capture <file>          Record all inbound WebSocket traffic to <file> for notifier_replay\n"
+        << "  --memory-budget <bytes>   Total bytes all notifications may use (default 64 MiB, 0 = unlimited)\n"
+        << "  --session-budget <bytes>  Bytes a single session's notifications may use (default 8 MiB, 0 = unlimited)\n"
+        << "  --dedup-window <seconds>  Return the existing notification for identical creates within this window (default 0 = off)\n"
+        << "  --digest-interval <seconds> Deliver held low-priority notifications after this long (default 60, 0 = no digests)\n"
+        << "  --digest-size <count>     Deliver a digest as soon as this many are held (default 20, 0 = no size limit)\n"
+        << "  --leader                  Stream notification changes to followers on ws://<host>:<port>/replicate\n"
+        << "  --follow <host:port>      Mirror the notifications of the leader at <host:port>\n"
+        << "  --shm-ingest <socket>     Accept same-host producers over shared memory via <socket> (Linux only)\n";
+}
+
+int main(int argc, char* argv[]) {
+    int port = 9001;
+    std::string capturePath;
+    bool leader = false;
+    std::string leaderHost;
+    int leaderPort = 0;
+    size_t memoryBudget = 64 * 1024 * 1024;
+    size_t sessionBudget = 8 * 1024 * 1024;
+    size_t dedupWindowSeconds = 0;
+    size_t digestIntervalSeconds = 60;
+    size_t digestSize = 20;
+    std::string shmSocketPath;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--port" && i + 1 < argc) {
+                port = std::stoi(argv[++i]);
+            }
+            else if (arg == "--capture" && i + 1 < argc) {
+                capturePath = argv[++i];
+            }
+            else if (arg == "--leader") {
+                leader = true;
+            }
+            else if (arg == "--follow" && i + 1 < argc) {
+                std::string address = argv[++i];
+                size_t separator = address.rfind(':');
+                if (separator == std::string::npos) {
+                    throw std::invalid_argument("Expected <host:port>");
+                }
+                leaderHost = address.substr(0, separator);
+                leaderPort = std::stoi(address.substr(separator + 1));
+            }
+            else if (arg == "--shm-ingest" && i + 1 < argc) {
+                shmSocketPath = argv[++i];
+            }
+            else if (arg == "--memory-budget" && i + 1 < argc) {
+                memoryBudget = std::stoull(argv[++i]);
+            }
+            else if (arg == "--session-budget" && i + 1 < argc) {
+                sessionBudget = std::stoull(argv[++i]);
+            }
+            else if (arg == "--dedup-window" && i + 1 < argc) {
+                dedupWindowSeconds = std::stoull(argv[++i]);
+            }
+            else if (arg == "--digest-interval" && i + 1 < argc) {
+                digestIntervalSeconds = std::stoull(argv[++i]);
+            }
+            else if (arg == "--digest-size" && i + 1 < argc) {
+                digestSize = std::stoull(argv[++i]);
+            }
+            else {
+                printUsage(argv[0]);
+                return arg == "--help" ? 0 : 1;
+            }
+        }
+    }
+    catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
 
     NotificationManager& manager = NotificationManager::getInstance();
-    WebSocketServer server(manager);
+    if (dedupWindowSeconds) {
+        manager.enableDeduplication(1024, std::chrono::seconds(dedupWindowSeconds));
+    }
+    if (digestIntervalSeconds) {
+        manager.enableDigest(std::chrono::seconds(digestIntervalSeconds), digestSize);
+    }
+    manager.setMemoryBudget(memoryBudget, sessionBudget);
+    WebSocketServer server(manager, port);
+    TerminalUI::port = port;
+
+    if (leader) {
+        server.enableLeader();
+    }
+    if (!leaderHost.empty()) {
+        server.enableFollower(leaderHost, leaderPort);
+    }
+
+    if (!shmSocketPath.empty()) {
+#ifdef __linux__
+        server.enableShmIngest(shmSocketPath);
+#else
+        std::cerr << "[ERROR] --shm-ingest is only supported on Linux." << std::endl;
+        return 1;
+#endif
+    }
+
+    if (!capturePath.empty()) {
+        try {
+            server.enableCapture(capturePath);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[ERROR] " << e.what() << std::endl;
+            return 1;
+        }
+    }
 
     std::thread serverThread([&server]() {
         try {
@@ -63,6 +177,7 @@ int main() {
         serverThread.join();
     }
 
+    NotificationBackend::cleanup();
     std::cout << "[INFO] Program exited gracefully." << std::endl;
     return 0;
 }
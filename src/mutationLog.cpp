@@ -0,0 +1,118 @@
+#include "mutationLog.h"
+#include <chrono>
+#include <random>
+#include <stdexcept>
+
+const char* mutationTypeToString(MutationType type) {
+    switch (type) {
+    case MutationType::Created: return "created";
+    case MutationType::Updated: return "updated";
+    case MutationType::Removed: return "removed";
+    case MutationType::Evicted: return "evicted";
+    }
+    return "unknown";
+}
+
+MutationType parseMutationType(const std::string& type) {
+    if (type == "created") return MutationType::Created;
+    if (type == "updated") return MutationType::Updated;
+    if (type == "removed") return MutationType::Removed;
+    if (type == "evicted") return MutationType::Evicted;
+    throw std::runtime_error("Unknown mutation type: " + type);
+}
+
+std::string Mutation::renderTitle() const {
+    return notificationTemplate ? notificationTemplate->renderTitle(templateParameters) : title;
+}
+
+std::string Mutation::renderMessage() const {
+    return notificationTemplate ? notificationTemplate->renderMessage(templateParameters) : message;
+}
+
+size_t Mutation::getMemoryFootprint() const {
+    size_t footprint = sizeof(Mutation) + title.capacity() + message.capacity() + sessionID.capacity() + notificationID.capacity();
+    for (const auto& parameter : templateParameters) {
+        footprint += sizeof(std::string) + parameter.capacity();
+    }
+    if (notificationTemplate) {
+        footprint += notificationTemplate->getMemoryFootprint();
+    }
+    return footprint;
+}
+
+MutationLog::MutationLog(size_t capacity, size_t byteCapacity)
+    : capacity(capacity), byteCapacity(byteCapacity) {
+    // Identifies this run of the log, so a replica that reconnects after a leader
+    // restart does not mistake the new sequence numbers for the old ones.
+    std::random_device random;
+    logID = std::to_string(random()) + "-" + std::to_string(random());
+}
+
+void MutationLog::append(Mutation mutation) {
+    mutation.sequence = ++lastSequence;
+    mutation.timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    for (const auto& [subscriptionID, listener] : listeners) {
+        listener(mutation);
+    }
+    if (!retained) {
+        return;
+    }
+
+    size_t footprint = mutation.getMemoryFootprint();
+    while (!entries.empty() && (entries.size() >= capacity || retainedBytes + footprint > byteCapacity)) {
+        retainedBytes -= entries.front().getMemoryFootprint();
+        entries.pop_front();
+    }
+    if (footprint > byteCapacity) {
+        // Too large to keep at all. The log is empty now, so anyone behind this entry
+        // catches up from a snapshot.
+        return;
+    }
+    retainedBytes += footprint;
+    entries.push_back(std::move(mutation));
+}
+
+size_t MutationLog::subscribe(std::function<void(const Mutation&)> listener) {
+    listeners.emplace_back(nextSubscriptionID, std::move(listener));
+    return nextSubscriptionID++;
+}
+
+void MutationLog::unsubscribe(size_t subscriptionID) {
+    std::erase_if(listeners, [subscriptionID](const auto& entry) { return entry.first == subscriptionID; });
+}
+
+bool MutationLog::readFrom(uint64_t fromSequence, std::vector<Mutation>& out) const {
+    if (fromSequence > lastSequence) {
+        return fromSequence == lastSequence + 1;
+    }
+    if (entries.empty() || fromSequence < entries.front().sequence) {
+        return false;
+    }
+
+    for (auto it = entries.begin() + (fromSequence - entries.front().sequence); it != entries.end(); ++it) {
+        out.push_back(*it);
+    }
+    return true;
+}
+
+uint64_t MutationLog::getLastSequence() const {
+    return lastSequence;
+}
+
+const std::string& MutationLog::getLogID() const {
+    return logID;
+}
+
+void MutationLog::setRetained(bool retain) {
+    retained = retain;
+    if (!retained) {
+        entries.clear();
+        retainedBytes = 0;
+    }
+}
+
+size_t MutationLog::getRetainedBytes() const {
+    return retainedBytes;
+}
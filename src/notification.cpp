@@ -1,25 +1,110 @@
 #include "notification.h"
+#include <stdexcept>
+
+PriorityEnum parsePriority(const std::string& priority) {
+    if (priority == "low") return PriorityEnum::Low;
+    if (priority == "normal") return PriorityEnum::Normal;
+    if (priority == "high") return PriorityEnum::High;
+    throw std::runtime_error("Unknown priority: " + priority);
+}
+
+const char* priorityToString(PriorityEnum priority) {
+    switch (priority) {
+    case PriorityEnum::Low: return "low";
+    case PriorityEnum::Normal: return "normal";
+    case PriorityEnum::High: return "high";
+    }
+    return "normal";
+}
 
 Notification::Notification(const std::string& title,
     const std::string& message,
     const std::string& notificationID,
     const std::string& sessionID,
     StatusEnum status,
+    PriorityEnum priority,
     std::chrono::system_clock::time_point creationTime)
     : _title(title), _message(message), _notificationID(notificationID),
-    _sessionID(sessionID), _status(status), _creationTime(creationTime) {
+    _sessionID(sessionID), _status(status), _priority(priority), _creationTime(creationTime) {
 }
 
-const std::string& Notification::getTitle() const { return _title; }
-const std::string& Notification::getMessage() const { return _message; }
+const std::string& Notification::getTitle() const { renderTemplate(); return _title; }
+const std::string& Notification::getMessage() const { renderTemplate(); return _message; }
 const std::string& Notification::getNotificationID() const { return _notificationID; }
 const std::string& Notification::getSessionID() const { return _sessionID; }
 StatusEnum Notification::getStatus() const { return _status; }
+PriorityEnum Notification::getPriority() const { return _priority; }
 std::chrono::system_clock::time_point Notification::getCreationTime() const { return _creationTime; }
+const std::shared_ptr<const NotificationTemplate>& Notification::getTemplate() const { return _template; }
+const std::vector<std::string>& Notification::getTemplateParameters() const { return _templateParameters; }
+
+// Bytes this notification pins: the object itself plus any string storage that does not
+// fit in the small-string buffer (capacity + terminator). A template is shared by every
+// notification created from it and is charged to its session when it is registered, so
+// only the parameters are counted here, along with the rendered text it caches. That text
+// is sized from the template rather than measured, so the footprint does not change when
+// the notification is first displayed.
+size_t Notification::getMemoryFootprint() const {
+    static const size_t inlineCapacity = std::string().capacity();
+    auto heapBytesFor = [](size_t capacity) {
+        return capacity > inlineCapacity ? capacity + 1 : 0;
+    };
+    auto heapBytes = [&](const std::string& value) {
+        return heapBytesFor(value.capacity());
+    };
+    size_t footprint = sizeof(Notification) + heapBytes(_notificationID) + heapBytes(_sessionID);
+    if (_template) {
+        footprint += heapBytesFor(_template->getRenderedTitleLength(_templateParameters));
+        footprint += heapBytesFor(_template->getRenderedMessageLength(_templateParameters));
+    }
+    else {
+        footprint += heapBytes(_title) + heapBytes(_message);
+    }
+    footprint += _templateParameters.capacity() * sizeof(std::string);
+    for (const auto& parameter : _templateParameters) {
+        footprint += heapBytes(parameter);
+    }
+    return footprint;
+}
+
+
+void Notification::setTitle(const std::string& title) {
+    if (_template) {
+        renderTemplate();
+        setTemplate(nullptr, {});
+    }
+    _title = title;
+};
+
+void Notification::setMessage(const std::string& message) {
+    if (_template) {
+        renderTemplate();
+        setTemplate(nullptr, {});
+    }
+    _message = message;
+};
 
+void Notification::setPriority(PriorityEnum priority) { _priority = priority; };
 
-void Notification::setTitle(const std::string& title) { _title = title; };
-void Notification::setMessage(const std::string& message) { _message = message; };
+void Notification::setTemplate(std::shared_ptr<const NotificationTemplate> notificationTemplate, std::vector<std::string> parameters) {
+    _template = std::move(notificationTemplate);
+    _templateParameters = std::move(parameters);
+    _rendered = false;
+    if (_template) {
+        _title.clear();
+        _title.shrink_to_fit();
+        _message.clear();
+        _message.shrink_to_fit();
+    }
+}
+
+void Notification::renderTemplate() const {
+    if (_template && !_rendered) {
+        _title = _template->renderTitle(_templateParameters);
+        _message = _template->renderMessage(_templateParameters);
+        _rendered = true;
+    }
+}
 
 
 NotificationBuilder& NotificationBuilder::setTitle(const std::string& title) {
@@ -47,11 +132,26 @@ NotificationBuilder& NotificationBuilder::setStatus(StatusEnum status) {
     return *this;
 }
 
+NotificationBuilder& NotificationBuilder::setPriority(PriorityEnum priority) {
+    _priority = priority;
+    return *this;
+}
+
 NotificationBuilder& NotificationBuilder::setCreationTime(std::chrono::system_clock::time_point creationTime) {
     _creationTime = creationTime;
     return *this;
 }
 
+NotificationBuilder& NotificationBuilder::setTemplate(std::shared_ptr<const NotificationTemplate> notificationTemplate, std::vector<std::string> parameters) {
+    _template = std::move(notificationTemplate);
+    _templateParameters = std::move(parameters);
+    return *this;
+}
+
 Notification NotificationBuilder::build() const {
-    return Notification(_title, _message, _notificationID, _sessionID, _status, _creationTime);
+    Notification notification(_template ? "" : _title, _template ? "" : _message, _notificationID, _sessionID, _status, _priority, _creationTime);
+    if (_template) {
+        notification.setTemplate(_template, _templateParameters);
+    }
+    return notification;
 }
@@ -0,0 +1,33 @@
+#include "notificationBackend.h"
+
+#ifdef _WIN32
+#include "windows_api.h"
+
+void NotificationBackend::show(const std::string&, const std::string& title, const std::string& message) {
+    WindowsAPI::showNotification(title, message);
+}
+
+// Toasts are not tagged, so there is nothing to withdraw; they expire on their own.
+void NotificationBackend::close(const std::string&) {
+}
+
+void NotificationBackend::cleanup() {
+    WindowsAPI::cleanup();
+}
+
+#else
+#include "linux_api.h"
+
+void NotificationBackend::show(const std::string& key, const std::string& title, const std::string& message) {
+    LinuxAPI::showNotification(key, title, message);
+}
+
+void NotificationBackend::close(const std::string& key) {
+    LinuxAPI::closeNotification(key);
+}
+
+void NotificationBackend::cleanup() {
+    LinuxAPI::cleanup();
+}
+
+#endif
@@ -1,7 +1,9 @@
 #include "notificationManager.h"
 #include "terminalUI.h"
-#include "windows_api.h"
+#include "notificationBackend.h"
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <stdexcept>
 
 
 NotificationManager& NotificationManager::getInstance() {
@@ -21,26 +23,116 @@ void NotificationManager::addSession(const std::string& sessionID) {
     TerminalUI::refreshScreen();
 }
 
+size_t NotificationManager::registerTemplate(const std::string& sessionID, const std::string& templateID,
+    const std::string& title, const std::string& message) {
+    if (!sessionToNotificationMap.count(sessionID)) {
+        throw std::runtime_error("SessionID " + sessionID + " not found");
+    }
+    if (templateID.empty()) {
+        throw std::runtime_error("templateID must not be empty");
+    }
+
+    auto& templates = sessionTemplates[sessionID];
+    if (!templates.count(templateID) && templates.size() >= MAX_TEMPLATES_PER_SESSION) {
+        throw std::runtime_error("Session already has " + std::to_string(MAX_TEMPLATES_PER_SESSION) + " templates");
+    }
+
+    // A template is charged to its session only while it is registered, so it may not be
+    // replaced while notifications still hold on to it.
+    auto existing = templates.find(templateID);
+    if (existing != templates.end()) {
+        for (const auto& notificationID : sessionToNotificationMap[sessionID]) {
+            auto it = notifications.find(notificationID);
+            if (it != notifications.end() && it->second->getTemplate() == existing->second) {
+                throw std::runtime_error("Template " + templateID + " is still used by notification " + notificationID);
+            }
+        }
+    }
+
+    auto notificationTemplate = std::make_shared<const NotificationTemplate>(title, message);
+    size_t footprint = notificationTemplate->getMemoryFootprint();
+    size_t oldFootprint = existing != templates.end() ? existing->second->getMemoryFootprint() : 0;
+    if (footprint > oldFootprint) {
+        reserveMemory(sessionID, "", footprint, footprint - oldFootprint);
+    }
+
+    releaseMemory(sessionID, oldFootprint);
+    chargeMemory(sessionID, footprint);
+    templates[templateID] = notificationTemplate;
+    return notificationTemplate->getParameterCount();
+}
+
 std::string NotificationManager::createNotification(const std::string& sessionID, const nlohmann::json& payload) {
     if (!sessionToNotificationMap.count(sessionID)) {
         std::cerr << "[ERROR] SessionID: " << sessionID << " not found. Unauthorized attempt!" << std::endl;
         return "";
     }
 
-    std::string title = payload["title"];
-    std::string msg = payload["message"];
+    PriorityEnum priority = parsePriority(payload.value("priority", "normal"));
+    std::string idempotencyKey = payload.value("idempotencyKey", "");
+    NotificationBuilder builder;
+    builder.setPriority(priority);
+
+    uint64_t contentHash = 0;
+    if (payload.contains("templateID")) {
+        auto notificationTemplate = findTemplate(sessionID, payload["templateID"].get<std::string>());
+        auto parameters = parseTemplateParameters(payload.value("params", nlohmann::json::array()), *notificationTemplate);
+        if (dedupCache) {
+            contentHash = DedupCache::hashTemplate(sessionID, notificationTemplate->getFingerprint(), parameters, idempotencyKey);
+        }
+        builder.setTemplate(std::move(notificationTemplate), std::move(parameters));
+    }
+    else {
+        std::string title = payload["title"];
+        std::string msg = payload["message"];
+        if (dedupCache) {
+            contentHash = DedupCache::hashContent(sessionID, title, msg, idempotencyKey);
+        }
+        builder.setTitle(title).setMessage(msg);
+    }
+
+    if (dedupCache) {
+        auto existingID = dedupCache->lookup(contentHash, DedupCache::Clock::now());
+        if (existingID && isSessionAuthorized(sessionID, *existingID)) {
+            // A duplicate sent with a higher priority escalates the existing notification,
+            // so a high-priority repeat of something waiting in a digest is shown now.
+            Notification& existing = *notifications[*existingID];
+            if (priority > existing.getPriority()) {
+                existing.setPriority(priority);
+                touchNotification(*existingID);
+                logMutation(MutationType::Updated, existing);
+                deliverNotification(sessionID, *existingID);
+            }
+            return *existingID;
+        }
+    }
+
+    std::string notificationID = insertNotification(sessionID, std::move(builder), true);
 
+    if (dedupCache) {
+        dedupCache->insert(contentHash, notificationID, DedupCache::Clock::now());
+    }
+
+    return notificationID;
+}
+
+std::string NotificationManager::storeNotification(const std::string& sessionID, const std::string& title, const std::string& msg,
+    PriorityEnum priority, bool display) {
+    NotificationBuilder builder;
+    builder.setTitle(title).setMessage(msg).setPriority(priority);
+    return insertNotification(sessionID, std::move(builder), display);
+}
+
+std::string NotificationManager::insertNotification(const std::string& sessionID, NotificationBuilder builder, bool display) {
     std::optional<std::string> notificationIDOpt = allocateNotificationID();
     if (!notificationIDOpt) {
         std::cerr << "[ERROR] No available notification IDs!" << std::endl;
-        return "No available session ID";
+        throw std::runtime_error("No available notification IDs");
     }
     std::string notificationID = *notificationIDOpt;
 
     auto notification = std::make_unique<Notification>(
-        NotificationBuilder()
-        .setTitle(title)
-        .setMessage(msg)
+        builder
         .setNotificationID(notificationID)
         .setSessionID(sessionID)
         .setStatus(StatusEnum::Active)
@@ -48,11 +140,25 @@ std::string NotificationManager::createNotification(const std::string& sessionID
         .build()
     );
 
+    size_t footprint = notification->getMemoryFootprint();
+    try {
+        reserveMemory(sessionID, "", footprint, footprint);
+    }
+    catch (const std::exception&) {
+        freeNotificationID(notificationID);
+        throw;
+    }
+
     notifications[notificationID] = std::move(notification);
     sessionToNotificationMap[sessionID].insert(notificationID);
+    chargeMemory(sessionID, footprint);
+    touchNotification(notificationID);
+    logMutation(MutationType::Created, *notifications[notificationID]);
 
     TerminalUI::refreshScreen();
-    displayNotification(sessionID, notificationID);
+    if (display) {
+        deliverNotification(sessionID, notificationID);
+    }
 
     return notificationID;
 }
@@ -64,10 +170,36 @@ void NotificationManager::updateNotification(const std::string& sessionID, const
 
     auto it = notifications.find(notificationID);
     if (it != notifications.end()) {
-        if (payload.contains("title")) it->second->setTitle(payload["title"]);
-        if (payload.contains("message")) it->second->setMessage(payload["message"]);
+        Notification updated = *it->second;
+        if (payload.contains("templateID")) {
+            auto notificationTemplate = findTemplate(sessionID, payload["templateID"].get<std::string>());
+            auto parameters = parseTemplateParameters(payload.value("params", nlohmann::json::array()), *notificationTemplate);
+            updated.setTemplate(std::move(notificationTemplate), std::move(parameters));
+        }
+        else if (payload.contains("params")) {
+            if (!updated.getTemplate()) {
+                throw std::runtime_error("Notification " + notificationID + " was not created from a template");
+            }
+            updated.setTemplate(updated.getTemplate(), parseTemplateParameters(payload["params"], *updated.getTemplate()));
+        }
+        if (payload.contains("title")) updated.setTitle(payload["title"]);
+        if (payload.contains("message")) updated.setMessage(payload["message"]);
+        if (payload.contains("priority")) updated.setPriority(parsePriority(payload["priority"]));
+
+        size_t oldFootprint = it->second->getMemoryFootprint();
+        size_t newFootprint = updated.getMemoryFootprint();
+        if (newFootprint > oldFootprint) {
+            reserveMemory(sessionID, notificationID, newFootprint, newFootprint - oldFootprint);
+        }
+
+        *it->second = std::move(updated);
+        releaseMemory(sessionID, oldFootprint);
+        chargeMemory(sessionID, newFootprint);
+        touchNotification(notificationID);
+        logMutation(MutationType::Updated, *it->second);
+        if (dedupCache) dedupCache->invalidate(notificationID);
         TerminalUI::refreshScreen();
-        displayNotification(sessionID, notificationID);
+        deliverNotification(sessionID, notificationID);
     }
     else {
         std::cerr << "Notification ID: " << notificationID << " not found." << std::endl;
@@ -81,9 +213,8 @@ void NotificationManager::removeNotification(const std::string& sessionID, const
     }
 
     sessionToNotificationMap[sessionID].erase(notificationID);
-
-    notifications.erase(notificationID); 
-    freeNotificationID(notificationID);
+    logMutation(MutationType::Removed, *notifications[notificationID]);
+    releaseNotification(notificationID);
     TerminalUI::refreshScreen();
 }
 
@@ -96,11 +227,26 @@ void NotificationManager::removeSession(const std::string& sessionID) {
     }
 
     for (const auto& notificationID : sessionIt->second) {
-        notifications.erase(notificationID);
-        freeNotificationID(notificationID);
+        if (auto it = notifications.find(notificationID); it != notifications.end()) {
+            logMutation(MutationType::Removed, *it->second);
+        }
+        releaseNotification(notificationID);
+    }
+
+    if (auto templatesIt = sessionTemplates.find(sessionID); templatesIt != sessionTemplates.end()) {
+        for (const auto& [templateID, notificationTemplate] : templatesIt->second) {
+            releaseMemory(sessionID, notificationTemplate->getMemoryFootprint());
+        }
+        sessionTemplates.erase(templatesIt);
     }
 
     sessionToNotificationMap.erase(sessionID);
+    sessionMemoryUsage.erase(sessionID);
+    NotificationBackend::close("digest-" + sessionID);
+    if (auto digestIt = sessionDigests.find(sessionID); digestIt != sessionDigests.end()) {
+        digestStats.pendingNotifications -= digestIt->second.notificationIDs.size();
+        sessionDigests.erase(digestIt);
+    }
 
     TerminalUI::refreshScreen();
 }
@@ -114,7 +260,8 @@ void NotificationManager::displayNotification(const std::string& sessionID, cons
 
     auto it = notifications.find(notificationID);
     if (it != notifications.end()) {
-        WindowsAPI::showNotification(it->second->getTitle(), it->second->getMessage());
+        touchNotification(notificationID);
+        NotificationBackend::show(notificationID, it->second->getTitle(), it->second->getMessage());
     }
     else {
         std::cerr << "No notification found with ID: " << notificationID << std::endl;
@@ -130,11 +277,122 @@ void NotificationManager::displayAllNotifications(const std::string& sessionID)
     for (const auto& notificationID : sessionToNotificationMap[sessionID]) {
         auto it = notifications.find(notificationID);
         if (it != notifications.end()) {
-            WindowsAPI::showNotification(it->second->getTitle(), it->second->getMessage());
+            NotificationBackend::show(notificationID, it->second->getTitle(), it->second->getMessage());
         }
     }
 }
 
+void NotificationManager::enableDigest(std::chrono::seconds interval, size_t maxBatchSize) {
+    digestEnabled = true;
+    digestInterval = interval;
+    digestMaxBatchSize = maxBatchSize;
+}
+
+void NotificationManager::flushDueDigests() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::string> dueSessions;
+    for (const auto& [sessionID, digest] : sessionDigests) {
+        if (!digest.notificationIDs.empty() && now - digest.firstQueuedAt >= digestInterval) {
+            dueSessions.push_back(sessionID);
+        }
+    }
+
+    for (const auto& sessionID : dueSessions) {
+        flushDigest(sessionID);
+    }
+}
+
+std::optional<DigestStats> NotificationManager::getDigestStats() const {
+    if (!digestEnabled) {
+        return std::nullopt;
+    }
+
+    // Every digested create/update would have been its own toast; whatever is neither
+    // still pending nor an actual digest delivery is a toast we did not have to show.
+    DigestStats result = digestStats;
+    result.deliveriesSaved = result.notificationsDigested - result.pendingNotifications - result.digestsDelivered;
+    return result;
+}
+
+// Low-priority notifications are held back and delivered as a single summary toast;
+// everything else is shown straight away.
+void NotificationManager::deliverNotification(const std::string& sessionID, const std::string& notificationID) {
+    auto it = notifications.find(notificationID);
+    if (digestEnabled && it != notifications.end() && it->second->getPriority() == PriorityEnum::Low) {
+        queueForDigest(sessionID, notificationID);
+        return;
+    }
+    dropFromDigest(sessionID, notificationID);
+    displayNotification(sessionID, notificationID);
+}
+
+void NotificationManager::queueForDigest(const std::string& sessionID, const std::string& notificationID) {
+    DigestBuffer& digest = sessionDigests[sessionID];
+    if (digest.notificationIDs.empty()) {
+        digest.firstQueuedAt = std::chrono::steady_clock::now();
+    }
+
+    ++digestStats.notificationsDigested;
+    if (std::find(digest.notificationIDs.begin(), digest.notificationIDs.end(), notificationID) != digest.notificationIDs.end()) {
+        // An update to a notification that is already waiting is folded into the same digest.
+        return;
+    }
+
+    digest.notificationIDs.push_back(notificationID);
+    ++digestStats.pendingNotifications;
+
+    if (digestMaxBatchSize && digest.notificationIDs.size() >= digestMaxBatchSize) {
+        flushDigest(sessionID);
+    }
+}
+
+void NotificationManager::dropFromDigest(const std::string& sessionID, const std::string& notificationID) {
+    auto digestIt = sessionDigests.find(sessionID);
+    if (digestIt == sessionDigests.end()) {
+        return;
+    }
+
+    auto& pending = digestIt->second.notificationIDs;
+    auto it = std::find(pending.begin(), pending.end(), notificationID);
+    if (it != pending.end()) {
+        pending.erase(it);
+        --digestStats.pendingNotifications;
+    }
+}
+
+void NotificationManager::flushDigest(const std::string& sessionID) {
+    auto digestIt = sessionDigests.find(sessionID);
+    if (digestIt == sessionDigests.end() || digestIt->second.notificationIDs.empty()) {
+        return;
+    }
+
+    std::vector<std::string> pending = std::move(digestIt->second.notificationIDs);
+    digestIt->second.notificationIDs.clear();
+    digestStats.pendingNotifications -= pending.size();
+    ++digestStats.digestsDelivered;
+
+    if (pending.size() == 1) {
+        displayNotification(sessionID, pending.front());
+        return;
+    }
+
+    std::string title = std::to_string(pending.size()) + " updates from session " + sessionID;
+    std::string message;
+    for (const auto& notificationID : pending) {
+        auto it = notifications.find(notificationID);
+        if (it == notifications.end()) {
+            continue;
+        }
+        if (!message.empty()) {
+            message += "\n";
+        }
+        message += it->second->getTitle() + ": " + it->second->getMessage();
+    }
+
+    // One summary per session, replaced in place by the next digest where the backend supports it.
+    NotificationBackend::show("digest-" + sessionID, title, message);
+}
+
 std::unordered_map<std::string, std::pair<std::string, std::string>> NotificationManager::getActiveNotifications() {
     std::unordered_map<std::string, std::pair<std::string, std::string>> activeNotifications;
 
@@ -145,6 +403,216 @@ std::unordered_map<std::string, std::pair<std::string, std::string>> Notificatio
     return activeNotifications;
 }
 
+void NotificationManager::enableDeduplication(size_t capacity, std::chrono::seconds window) {
+    dedupCache.emplace(capacity, window);
+}
+
+std::optional<DedupStats> NotificationManager::getDedupStats() const {
+    if (!dedupCache) {
+        return std::nullopt;
+    }
+    return dedupCache->getStats();
+}
+
+void NotificationManager::setMemoryBudget(size_t globalBytes, size_t sessionBytes) {
+    globalMemoryBudget = globalBytes;
+    sessionMemoryBudget = sessionBytes;
+}
+
+void NotificationManager::setEvictionListener(std::function<void(const std::string&, const std::string&)> listener) {
+    evictionListener = std::move(listener);
+}
+
+MemoryStats NotificationManager::getMemoryStats() const {
+    MemoryStats stats;
+    stats.totalBytes = totalMemoryUsage;
+    stats.globalBudget = globalMemoryBudget;
+    stats.sessionBudget = sessionMemoryBudget;
+    stats.evictions = memoryEvictions;
+    stats.sessionBytes = sessionMemoryUsage;
+    return stats;
+}
+
+// Makes room for a notification of `footprint` bytes that adds `additionalBytes` to its
+// session, evicting the least recently used notifications (never `protectedID`) as needed.
+void NotificationManager::reserveMemory(const std::string& sessionID, const std::string& protectedID, size_t footprint, size_t additionalBytes) {
+    if ((sessionMemoryBudget && footprint > sessionMemoryBudget) || (globalMemoryBudget && footprint > globalMemoryBudget)) {
+        throw std::runtime_error(std::to_string(footprint) + " bytes exceed the memory budget");
+    }
+
+    while (sessionMemoryBudget && sessionMemoryUsage[sessionID] + additionalBytes > sessionMemoryBudget) {
+        if (!evictLeastRecentlyUsed(&sessionID, protectedID)) {
+            throw std::runtime_error("Session memory budget exceeded");
+        }
+    }
+    while (globalMemoryBudget && totalMemoryUsage + additionalBytes > globalMemoryBudget) {
+        if (!evictLeastRecentlyUsed(nullptr, protectedID)) {
+            throw std::runtime_error("Global memory budget exceeded");
+        }
+    }
+}
+
+void NotificationManager::chargeMemory(const std::string& sessionID, size_t bytes) {
+    sessionMemoryUsage[sessionID] += bytes;
+    totalMemoryUsage += bytes;
+}
+
+void NotificationManager::releaseMemory(const std::string& sessionID, size_t bytes) {
+    auto it = sessionMemoryUsage.find(sessionID);
+    if (it != sessionMemoryUsage.end()) {
+        it->second -= std::min(it->second, bytes);
+    }
+    totalMemoryUsage -= std::min(totalMemoryUsage, bytes);
+}
+
+void NotificationManager::touchNotification(const std::string& notificationID) {
+    auto it = recencyIndex.find(notificationID);
+    if (it != recencyIndex.end()) {
+        recencyList.splice(recencyList.begin(), recencyList, it->second);
+        return;
+    }
+    recencyList.push_front(notificationID);
+    recencyIndex[notificationID] = recencyList.begin();
+}
+
+bool NotificationManager::evictLeastRecentlyUsed(const std::string* sessionID, const std::string& protectedID) {
+    for (auto it = recencyList.rbegin(); it != recencyList.rend(); ++it) {
+        const std::string notificationID = *it;
+        if (notificationID == protectedID) {
+            continue;
+        }
+
+        auto notificationIt = notifications.find(notificationID);
+        if (notificationIt == notifications.end()) {
+            continue;
+        }
+        const std::string ownerID = notificationIt->second->getSessionID();
+        if (sessionID && ownerID != *sessionID) {
+            continue;
+        }
+
+        std::cerr << "[WARNING] Memory budget exceeded. Evicting notification " << notificationID
+            << " of session " << ownerID << std::endl;
+
+        sessionToNotificationMap[ownerID].erase(notificationID);
+        logMutation(MutationType::Evicted, *notificationIt->second);
+        releaseNotification(notificationID);
+        ++memoryEvictions;
+
+        if (evictionListener) {
+            evictionListener(ownerID, notificationID);
+        }
+        return true;
+    }
+    return false;
+}
+
+// Frees everything a notification holds except its entry in sessionToNotificationMap,
+// which callers own because removeSession iterates over it.
+void NotificationManager::releaseNotification(const std::string& notificationID) {
+    auto it = notifications.find(notificationID);
+    if (it == notifications.end()) {
+        return;
+    }
+
+    const std::string sessionID = it->second->getSessionID();
+    releaseMemory(sessionID, it->second->getMemoryFootprint());
+    dropFromDigest(sessionID, notificationID);
+
+    if (auto recencyIt = recencyIndex.find(notificationID); recencyIt != recencyIndex.end()) {
+        recencyList.erase(recencyIt->second);
+        recencyIndex.erase(recencyIt);
+    }
+
+    notifications.erase(it);
+    NotificationBackend::close(notificationID);
+    freeNotificationID(notificationID);
+    if (dedupCache) dedupCache->invalidate(notificationID);
+}
+
+MutationLog& NotificationManager::getMutationLog() {
+    return mutationLog;
+}
+
+void NotificationManager::setMutationRecording(bool enabled) {
+    mutationRecording = enabled;
+}
+
+std::shared_ptr<const NotificationTemplate> NotificationManager::findTemplate(const std::string& sessionID, const std::string& templateID) const {
+    auto sessionIt = sessionTemplates.find(sessionID);
+    if (sessionIt != sessionTemplates.end()) {
+        if (auto it = sessionIt->second.find(templateID); it != sessionIt->second.end()) {
+            return it->second;
+        }
+    }
+    throw std::runtime_error("Unknown templateID: " + templateID);
+}
+
+std::vector<std::string> NotificationManager::parseTemplateParameters(const nlohmann::json& parameters, const NotificationTemplate& notificationTemplate) {
+    if (!parameters.is_array()) {
+        throw std::runtime_error("params must be an array");
+    }
+    if (parameters.size() != notificationTemplate.getParameterCount()) {
+        throw std::runtime_error("Template expects " + std::to_string(notificationTemplate.getParameterCount())
+            + " parameters, got " + std::to_string(parameters.size()));
+    }
+
+    std::vector<std::string> result;
+    result.reserve(parameters.size());
+    for (const auto& parameter : parameters) {
+        if (parameter.is_string()) {
+            result.push_back(parameter.get<std::string>());
+        }
+        else if (parameter.is_number() || parameter.is_boolean()) {
+            result.push_back(parameter.dump());
+        }
+        else {
+            throw std::runtime_error("Template parameters must be strings, numbers or booleans");
+        }
+    }
+    return result;
+}
+
+std::vector<Mutation> NotificationManager::snapshotNotifications() const {
+    std::vector<Mutation> snapshot;
+    snapshot.reserve(notifications.size());
+    for (const auto& [notificationID, notification] : notifications) {
+        Mutation entry;
+        entry.sequence = mutationLog.getLastSequence();
+        entry.type = MutationType::Created;
+        entry.sessionID = notification->getSessionID();
+        entry.notificationID = notificationID;
+        entry.title = notification->getTitle();
+        entry.message = notification->getMessage();
+        entry.priority = notification->getPriority();
+        snapshot.push_back(std::move(entry));
+    }
+    return snapshot;
+}
+
+void NotificationManager::logMutation(MutationType type, const Notification& notification) {
+    if (!mutationRecording) {
+        return;
+    }
+
+    Mutation mutation;
+    mutation.type = type;
+    mutation.sessionID = notification.getSessionID();
+    mutation.notificationID = notification.getNotificationID();
+    if (type == MutationType::Created || type == MutationType::Updated) {
+        if (notification.getTemplate()) {
+            mutation.notificationTemplate = notification.getTemplate();
+            mutation.templateParameters = notification.getTemplateParameters();
+        }
+        else {
+            mutation.title = notification.getTitle();
+            mutation.message = notification.getMessage();
+        }
+    }
+    mutation.priority = notification.getPriority();
+    mutationLog.append(std::move(mutation));
+}
+
 std::set<std::string> NotificationManager::getActiveSessions() {
     std::set<std::string> activeSessions;
     for (const auto& [sessionID, _] : sessionToNotificationMap) {
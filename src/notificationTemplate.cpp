@@ -0,0 +1,123 @@
+#include "notificationTemplate.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+    uint64_t hashText(uint64_t hash, const std::string& text) {
+        for (unsigned char c : text) {
+            hash = (hash ^ c) * FNV_PRIME;
+        }
+        return (hash ^ 0x1F) * FNV_PRIME;
+    }
+}
+
+NotificationTemplate::NotificationTemplate(const std::string& title, const std::string& message) {
+    titleSegments = compile(title);
+    messageSegments = compile(message);
+    fingerprint = hashText(hashText(FNV_OFFSET, title), message);
+}
+
+std::string NotificationTemplate::renderTitle(const std::vector<std::string>& parameters) const {
+    return render(titleSegments, parameters);
+}
+
+std::string NotificationTemplate::renderMessage(const std::vector<std::string>& parameters) const {
+    return render(messageSegments, parameters);
+}
+
+size_t NotificationTemplate::getRenderedTitleLength(const std::vector<std::string>& parameters) const {
+    return renderedLength(titleSegments, parameters);
+}
+
+size_t NotificationTemplate::getRenderedMessageLength(const std::vector<std::string>& parameters) const {
+    return renderedLength(messageSegments, parameters);
+}
+
+size_t NotificationTemplate::getParameterCount() const {
+    return parameterCount;
+}
+
+uint64_t NotificationTemplate::getFingerprint() const {
+    return fingerprint;
+}
+
+size_t NotificationTemplate::getMemoryFootprint() const {
+    static const size_t inlineCapacity = std::string().capacity();
+    size_t footprint = sizeof(NotificationTemplate);
+    for (const auto* segments : { &titleSegments, &messageSegments }) {
+        footprint += segments->capacity() * sizeof(Segment);
+        for (const auto& segment : *segments) {
+            footprint += segment.literal.capacity() > inlineCapacity ? segment.literal.capacity() + 1 : 0;
+        }
+    }
+    return footprint;
+}
+
+// Splits a pattern into literal runs, each optionally followed by a placeholder.
+std::vector<NotificationTemplate::Segment> NotificationTemplate::compile(const std::string& pattern) {
+    std::vector<Segment> segments;
+    std::string literal;
+
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        char c = pattern[i];
+        if ((c == '{' || c == '}') && i + 1 < pattern.size() && pattern[i + 1] == c) {
+            literal += c;
+            ++i;
+            continue;
+        }
+        if (c == '}') {
+            throw std::runtime_error("Unmatched '}' in template at position " + std::to_string(i));
+        }
+        if (c != '{') {
+            literal += c;
+            continue;
+        }
+
+        size_t close = pattern.find('}', i + 1);
+        std::string index = close == std::string::npos ? "" : pattern.substr(i + 1, close - i - 1);
+        if (index.empty() || index.size() > 2 || index.find_first_not_of("0123456789") != std::string::npos) {
+            throw std::runtime_error("Invalid placeholder in template at position " + std::to_string(i) + ", expected {0} to {"
+                + std::to_string(MAX_PARAMETERS - 1) + "}");
+        }
+        int parameter = std::stoi(index);
+        if (parameter >= static_cast<int>(MAX_PARAMETERS)) {
+            throw std::runtime_error("Template placeholder {" + index + "} exceeds the limit of " + std::to_string(MAX_PARAMETERS) + " parameters");
+        }
+
+        segments.push_back({ std::move(literal), parameter });
+        literal.clear();
+        parameterCount = std::max(parameterCount, static_cast<size_t>(parameter) + 1);
+        i = close;
+    }
+
+    if (!literal.empty() || segments.empty()) {
+        segments.push_back({ std::move(literal), -1 });
+    }
+    return segments;
+}
+
+size_t NotificationTemplate::renderedLength(const std::vector<Segment>& segments, const std::vector<std::string>& parameters) {
+    size_t length = 0;
+    for (const auto& segment : segments) {
+        length += segment.literal.size();
+        if (segment.parameter >= 0 && static_cast<size_t>(segment.parameter) < parameters.size()) {
+            length += parameters[segment.parameter].size();
+        }
+    }
+    return length;
+}
+
+std::string NotificationTemplate::render(const std::vector<Segment>& segments, const std::vector<std::string>& parameters) {
+    std::string text;
+    text.reserve(renderedLength(segments, parameters));
+    for (const auto& segment : segments) {
+        text += segment.literal;
+        if (segment.parameter >= 0 && static_cast<size_t>(segment.parameter) < parameters.size()) {
+            text += parameters[segment.parameter];
+        }
+    }
+    return text;
+}
@@ -0,0 +1,269 @@
+#include "replication.h"
+#include "websocketClient.h"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    const std::string REPLICA_SESSION_PREFIX = "replica-";
+
+    int64_t currentTimeMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+}
+
+nlohmann::json mutationToJson(const Mutation& mutation) {
+    nlohmann::json json = {
+        {"sequence", mutation.sequence},
+        {"op", mutationTypeToString(mutation.type)},
+        {"sessionID", mutation.sessionID},
+        {"notificationID", mutation.notificationID},
+        {"timestampMs", mutation.timestampMs},
+    };
+    if (mutation.type == MutationType::Created || mutation.type == MutationType::Updated) {
+        json["title"] = mutation.renderTitle();
+        json["message"] = mutation.renderMessage();
+        json["priority"] = priorityToString(mutation.priority);
+    }
+    return json;
+}
+
+Mutation mutationFromJson(const nlohmann::json& json) {
+    Mutation mutation;
+    mutation.sequence = json.at("sequence").get<uint64_t>();
+    mutation.type = parseMutationType(json.at("op").get<std::string>());
+    mutation.sessionID = json.at("sessionID").get<std::string>();
+    mutation.notificationID = json.at("notificationID").get<std::string>();
+    mutation.timestampMs = json.value("timestampMs", int64_t{ 0 });
+    mutation.title = json.value("title", "");
+    mutation.message = json.value("message", "");
+    mutation.priority = parsePriority(json.value("priority", "normal"));
+    return mutation;
+}
+
+ReplicationFollower::ReplicationFollower(const std::string& host, int port, NotificationManager& manager, uWS::Loop* loop)
+    : host(host), port(port), notificationManager(manager), loop(loop), running(false),
+    connected(false), leaderSequence(0), appliedSequence(0), lagMs(0), snapshotsApplied(0) {
+}
+
+ReplicationFollower::~ReplicationFollower() {
+    stop();
+}
+
+void ReplicationFollower::start() {
+    running = true;
+    worker = std::thread([this]() { run(); });
+}
+
+void ReplicationFollower::stop() {
+    running = false;
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+ReplicationStatus ReplicationFollower::getStatus() const {
+    ReplicationStatus status;
+    status.connected = connected;
+    status.leaderSequence = leaderSequence;
+    status.appliedSequence = appliedSequence;
+    status.lagMs = lagMs;
+    status.snapshotsApplied = snapshotsApplied;
+    return status;
+}
+
+// Runs on the worker thread. Parsing happens here; anything touching NotificationManager
+// is handed to the event loop with defer() so the manager stays single-threaded.
+void ReplicationFollower::run() {
+    std::string logID;
+    uint64_t nextSequence = 0;
+
+    while (running) {
+        try {
+            streamFromLeader(logID, nextSequence);
+        }
+        catch (const std::exception& e) {
+            if (connected) {
+                std::cerr << "[WARNING] Replication from " << host << ":" << port << " interrupted: " << e.what() << std::endl;
+            }
+        }
+        connected = false;
+
+        for (int waited = 0; running && waited < RECONNECT_DELAY_MS; waited += 100) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+}
+
+void ReplicationFollower::streamFromLeader(std::string& logID, uint64_t& nextSequence) {
+    WebSocketClient client;
+    client.connect(host, port, "/replicate");
+
+    nlohmann::json subscribe = { {"action", "subscribe"}, {"logID", logID}, {"fromSequence", nextSequence} };
+    client.sendText(subscribe.dump());
+    connected = true;
+
+    auto lastHeard = std::chrono::steady_clock::now();
+    std::string message;
+    while (running) {
+        if (!client.receive(message, 1000)) {
+            if (std::chrono::steady_clock::now() - lastHeard > std::chrono::milliseconds(LEADER_TIMEOUT_MS)) {
+                throw std::runtime_error("No heartbeat from leader");
+            }
+            continue;
+        }
+        lastHeard = std::chrono::steady_clock::now();
+
+        auto json = nlohmann::json::parse(message);
+        std::string type = json.at("type");
+
+        if (type == "snapshot") {
+            logID = json.at("logID");
+            uint64_t sequence = json.at("sequence");
+            std::vector<Mutation> snapshot;
+            for (const auto& entry : json.at("notifications")) {
+                snapshot.push_back(mutationFromJson(entry));
+            }
+            nextSequence = sequence + 1;
+            leaderSequence = sequence;
+            loop->defer([this, sequence, snapshot = std::move(snapshot)]() mutable {
+                applySnapshot(sequence, std::move(snapshot));
+            });
+        }
+        else if (type == "mutation") {
+            Mutation mutation = mutationFromJson(json);
+            if (mutation.sequence != nextSequence) {
+                // Resubscribing from nextSequence closes the gap.
+                throw std::runtime_error("Expected sequence " + std::to_string(nextSequence) +
+                    " but received " + std::to_string(mutation.sequence));
+            }
+            ++nextSequence;
+            if (mutation.sequence > leaderSequence) {
+                leaderSequence = mutation.sequence;
+            }
+            loop->defer([this, mutation = std::move(mutation)]() {
+                applyMutation(mutation);
+            });
+        }
+        else if (type == "heartbeat") {
+            if (json.at("logID") != logID) {
+                // The leader restarted with a fresh log; start over from a snapshot.
+                logID.clear();
+                nextSequence = 0;
+                throw std::runtime_error("Leader log changed");
+            }
+            leaderSequence = json.at("sequence").get<uint64_t>();
+        }
+    }
+}
+
+void ReplicationFollower::applySnapshot(uint64_t sequence, std::vector<Mutation> snapshot) {
+    for (const auto& sessionID : notificationManager.getActiveSessions()) {
+        if (sessionID.rfind(REPLICA_SESSION_PREFIX, 0) == 0) {
+            notificationManager.removeSession(sessionID);
+        }
+    }
+    replicatedIDs.clear();
+    replicaSessionSizes.clear();
+
+    for (const auto& entry : snapshot) {
+        std::string sessionID = localSessionID(entry.sessionID);
+        try {
+            std::string notificationID = notificationManager.storeNotification(sessionID,
+                entry.title, entry.message, entry.priority, false);
+            replicatedIDs[entry.notificationID] = notificationID;
+            ++replicaSessionSizes[sessionID];
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[ERROR] Failed to apply replicated notification " << entry.notificationID << ": " << e.what() << std::endl;
+            removeIfEmpty(sessionID);
+        }
+    }
+
+    appliedSequence = sequence;
+    lagMs = 0;
+    ++snapshotsApplied;
+}
+
+void ReplicationFollower::applyMutation(const Mutation& mutation) {
+    std::string sessionID = REPLICA_SESSION_PREFIX + mutation.sessionID;
+    try {
+        auto it = replicatedIDs.find(mutation.notificationID);
+
+        switch (mutation.type) {
+        case MutationType::Created:
+            localSessionID(mutation.sessionID);
+            replicatedIDs[mutation.notificationID] = notificationManager.storeNotification(sessionID,
+                mutation.title, mutation.message, mutation.priority, true);
+            ++replicaSessionSizes[sessionID];
+            break;
+        case MutationType::Updated:
+            if (it != replicatedIDs.end()) {
+                nlohmann::json payload = { {"title", mutation.title}, {"message", mutation.message},
+                    {"priority", priorityToString(mutation.priority)} };
+                notificationManager.updateNotification(sessionID, it->second, payload);
+            }
+            break;
+        case MutationType::Removed:
+        case MutationType::Evicted:
+            if (it != replicatedIDs.end()) {
+                notificationManager.removeNotification(sessionID, it->second);
+                replicatedIDs.erase(it);
+                releaseReplica(sessionID);
+            }
+            break;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[ERROR] Failed to apply replicated mutation " << mutation.sequence << ": " << e.what() << std::endl;
+        removeIfEmpty(sessionID);
+    }
+
+    appliedSequence = mutation.sequence;
+    lagMs = currentTimeMs() - mutation.timestampMs;
+}
+
+void ReplicationFollower::handleLocalEviction(const std::string& sessionID, const std::string& notificationID) {
+    if (sessionID.rfind(REPLICA_SESSION_PREFIX, 0) != 0) {
+        return;
+    }
+    for (auto it = replicatedIDs.begin(); it != replicatedIDs.end(); ++it) {
+        if (it->second == notificationID) {
+            replicatedIDs.erase(it);
+            break;
+        }
+    }
+
+    // The manager is still in the middle of making room, so the session is removed
+    // afterwards, and only if nothing was replicated into it in the meantime.
+    auto sizeIt = replicaSessionSizes.find(sessionID);
+    if (sizeIt != replicaSessionSizes.end() && --sizeIt->second == 0) {
+        replicaSessionSizes.erase(sizeIt);
+        loop->defer([this, sessionID]() {
+            removeIfEmpty(sessionID);
+        });
+    }
+}
+
+void ReplicationFollower::releaseReplica(const std::string& sessionID) {
+    auto it = replicaSessionSizes.find(sessionID);
+    if (it != replicaSessionSizes.end() && --it->second == 0) {
+        replicaSessionSizes.erase(it);
+        removeIfEmpty(sessionID);
+    }
+}
+
+void ReplicationFollower::removeIfEmpty(const std::string& sessionID) {
+    if (!replicaSessionSizes.count(sessionID) && notificationManager.getActiveSessions().count(sessionID)) {
+        notificationManager.removeSession(sessionID);
+    }
+}
+
+std::string ReplicationFollower::localSessionID(const std::string& leaderSessionID) {
+    std::string sessionID = REPLICA_SESSION_PREFIX + leaderSessionID;
+    if (!notificationManager.getActiveSessions().count(sessionID)) {
+        notificationManager.addSession(sessionID);
+    }
+    return sessionID;
+}
@@ -0,0 +1,372 @@
+#include "shmIngest.h"
+#include "terminalUI.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    std::string producerSessionID(uint32_t producerID) {
+        return "shm-" + std::to_string(producerID);
+    }
+
+    void signalEventFd(int fd) {
+        uint64_t one = 1;
+        [[maybe_unused]] auto written = ::write(fd, &one, sizeof(one));
+    }
+}
+
+ShmIngest::ShmIngest(const std::string& socketPath, uint32_t capacity, NotificationManager& manager, uWS::Loop* loop)
+    : socketPath(socketPath), capacity(capacity), notificationManager(manager), loop(loop), running(false),
+    pendingRecords(0), recordsApplied(0), batchesApplied(0), producersConnected(0) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        throw std::runtime_error("Shared-memory ring capacity must be a power of two");
+    }
+
+    wakeupFd = ::eventfd(0, EFD_CLOEXEC);
+    if (wakeupFd < 0) {
+        throw std::runtime_error("Failed to create ingest eventfd: " + std::string(std::strerror(errno)));
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Ingest socket path too long: " + socketPath);
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    ::unlink(socketPath.c_str());
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listenFd, 16) != 0) {
+        throw std::runtime_error("Failed to listen on ingest socket " + socketPath + ": " + std::strerror(errno));
+    }
+}
+
+ShmIngest::~ShmIngest() {
+    stop();
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        ::unlink(socketPath.c_str());
+    }
+    if (wakeupFd >= 0) ::close(wakeupFd);
+}
+
+void ShmIngest::start() {
+    running = true;
+    acceptThread = std::thread([this]() { acceptLoop(); });
+    drainThread = std::thread([this]() { drainLoop(); });
+    std::cout << "[INFO] Shared-memory ingest listening on " << socketPath << std::endl;
+}
+
+void ShmIngest::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    signalEventFd(wakeupFd);
+    if (acceptThread.joinable()) acceptThread.join();
+    if (drainThread.joinable()) drainThread.join();
+}
+
+ShmIngestStats ShmIngest::getStats() const {
+    ShmIngestStats stats;
+    stats.recordsApplied = recordsApplied;
+    stats.batchesApplied = batchesApplied;
+    stats.producersConnected = producersConnected;
+    stats.ringCapacity = capacity;
+    return stats;
+}
+
+ShmRingHeader* ShmIngest::createRing(int& ringFd) {
+    size_t ringBytes = shmRingBytes(capacity);
+    ringFd = ::memfd_create("notifier-ingest", MFD_CLOEXEC);
+    if (ringFd < 0) {
+        return nullptr;
+    }
+    void* mapping = MAP_FAILED;
+    if (::ftruncate(ringFd, static_cast<off_t>(ringBytes)) == 0) {
+        mapping = ::mmap(nullptr, ringBytes, PROT_READ | PROT_WRITE, MAP_SHARED, ringFd, 0);
+    }
+    if (mapping == MAP_FAILED) {
+        ::close(ringFd);
+        ringFd = -1;
+        return nullptr;
+    }
+    auto* ring = static_cast<ShmRingHeader*>(mapping);
+    shmRingInit(ring, capacity);
+    return ring;
+}
+
+void ShmIngest::destroyRing(ShmRingHeader* ring) {
+    ::munmap(ring, shmRingBytes(capacity));
+}
+
+// Gives each new producer its ID plus its own ring and the eventfd, and watches the
+// producer sockets so their rings and sessions can be dropped when they go away.
+void ShmIngest::acceptLoop() {
+    uint32_t nextProducerID = 0;
+    std::map<int, uint32_t> producerSockets;
+
+    while (running) {
+        std::vector<pollfd> descriptors{ { listenFd, POLLIN, 0 } };
+        for (const auto& [fd, producerID] : producerSockets) {
+            descriptors.push_back({ fd, POLLIN, 0 });
+        }
+        if (::poll(descriptors.data(), descriptors.size(), 200) <= 0) {
+            continue;
+        }
+
+        for (size_t i = 1; i < descriptors.size(); ++i) {
+            if (!descriptors[i].revents) {
+                continue;
+            }
+            char ignored[64];
+            if (::recv(descriptors[i].fd, ignored, sizeof(ignored), MSG_DONTWAIT) > 0) {
+                continue;
+            }
+            uint32_t producerID = producerSockets[descriptors[i].fd];
+            ::close(descriptors[i].fd);
+            producerSockets.erase(descriptors[i].fd);
+            --producersConnected;
+            {
+                std::lock_guard<std::mutex> lock(handoffMutex);
+                departedProducers.push_back(producerID);
+            }
+            signalEventFd(wakeupFd);
+        }
+
+        if (!(descriptors[0].revents & POLLIN)) {
+            continue;
+        }
+        int producerFd = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (producerFd < 0) {
+            continue;
+        }
+
+        int ringFd;
+        ShmRingHeader* ring = createRing(ringFd);
+        if (!ring) {
+            std::cerr << "[ERROR] Failed to create shared-memory ring: " << std::strerror(errno) << std::endl;
+            ::close(producerFd);
+            continue;
+        }
+
+        uint32_t producerID = nextProducerID++;
+        // Deferred before the handshake is sent, so the session exists before any of
+        // this producer's records can reach the event loop.
+        loop->defer([this, producerID]() {
+            activeProducers.insert(producerID);
+            notificationManager.addSession(producerSessionID(producerID));
+        });
+
+        uint32_t handshake[2] = { producerID, capacity };
+        iovec data{ handshake, sizeof(handshake) };
+        alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))] = {};
+        msghdr message{};
+        message.msg_iov = &data;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(2 * sizeof(int));
+        int fds[2] = { ringFd, wakeupFd };
+        std::memcpy(CMSG_DATA(header), fds, sizeof(fds));
+
+        bool sent = ::sendmsg(producerFd, &message, MSG_NOSIGNAL) == sizeof(handshake);
+        // The producer holds its own descriptor now, and the mapping keeps the memfd alive.
+        ::close(ringFd);
+        if (!sent) {
+            std::cerr << "[WARNING] Failed to hand the ingest ring to producer " << producerID << std::endl;
+            ::close(producerFd);
+            destroyRing(ring);
+            loop->defer([this, producerID]() { removeProducer(producerID); });
+            continue;
+        }
+        producerSockets[producerFd] = producerID;
+        ++producersConnected;
+        {
+            std::lock_guard<std::mutex> lock(handoffMutex);
+            arrivedRings.push_back({ producerID, ring, 0 });
+        }
+        signalEventFd(wakeupFd);
+    }
+
+    for (const auto& [fd, producerID] : producerSockets) {
+        ::close(fd);
+    }
+}
+
+void ShmIngest::drainLoop() {
+    std::map<uint32_t, ProducerRing> rings;
+
+    while (running) {
+        std::vector<uint32_t> departed;
+        {
+            std::lock_guard<std::mutex> lock(handoffMutex);
+            for (const auto& producerRing : arrivedRings) {
+                rings.emplace(producerRing.producerID, producerRing);
+            }
+            arrivedRings.clear();
+            departed.swap(departedProducers);
+        }
+
+        while (running) {
+            // Stop draining while the event loop is behind; producers then see a full ring.
+            while (running && pendingRecords.load() > MAX_PENDING_RECORDS) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            // Up to MAX_BATCH_SIZE records from each ring per pass, so one busy producer
+            // cannot starve the others.
+            std::vector<IngestRecord> batch;
+            for (auto& [producerID, producerRing] : rings) {
+                drainRing(producerRing, batch);
+            }
+            if (batch.empty()) {
+                break;
+            }
+
+            pendingRecords += batch.size();
+            loop->defer([this, batch = std::move(batch)]() { applyBatch(batch); });
+        }
+
+        // The rings have been drained after these producers hung up, so none of their
+        // records can still be waiting.
+        if (!departed.empty()) {
+            for (uint32_t producerID : departed) {
+                if (auto it = rings.find(producerID); it != rings.end()) {
+                    destroyRing(it->second.ring);
+                    rings.erase(it);
+                }
+            }
+            loop->defer([this, departed]() {
+                for (uint32_t producerID : departed) {
+                    removeProducer(producerID);
+                }
+            });
+            continue;
+        }
+
+        bool idle = true;
+        for (auto& [producerID, producerRing] : rings) {
+            if (!shmRingPrepareSleep(producerRing.ring, producerRing.readPosition, capacity)) {
+                idle = false;
+                break;
+            }
+        }
+        if (running && idle) {
+            uint64_t count;
+            [[maybe_unused]] auto bytesRead = ::read(wakeupFd, &count, sizeof(count));
+        }
+        for (auto& [producerID, producerRing] : rings) {
+            producerRing.ring->consumerSleeping.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    for (auto& [producerID, producerRing] : rings) {
+        destroyRing(producerRing.ring);
+    }
+    std::lock_guard<std::mutex> lock(handoffMutex);
+    for (const auto& producerRing : arrivedRings) {
+        destroyRing(producerRing.ring);
+    }
+    arrivedRings.clear();
+}
+
+void ShmIngest::drainRing(ProducerRing& producerRing, std::vector<IngestRecord>& batch) {
+    uint64_t available = std::min<uint64_t>(shmRingAvailable(producerRing.ring, producerRing.readPosition, capacity), MAX_BATCH_SIZE);
+    for (uint64_t i = 0; i < available; ++i) {
+        const ShmSlot* slot = shmRingSlot(producerRing.ring, producerRing.readPosition + i, capacity);
+        // Copied once and validated on the copy, since the producer may still be writing.
+        ShmRecord record = slot->record;
+        if (static_cast<size_t>(record.titleLength) + record.messageLength <= SHM_TEXT_CAPACITY) {
+            batch.push_back({ producerRing.producerID, record, std::string(slot->text, record.titleLength),
+                std::string(slot->text + record.titleLength, record.messageLength) });
+        }
+    }
+    if (available) {
+        producerRing.readPosition += available;
+        shmRingRelease(producerRing.ring, producerRing.readPosition);
+    }
+}
+
+void ShmIngest::applyBatch(const std::vector<IngestRecord>& batch) {
+    pendingRecords -= batch.size();
+    ++batchesApplied;
+    // One redraw for the whole batch instead of one per record.
+    TerminalUI::DeferredRefresh deferredRefresh;
+
+    for (const auto& entry : batch) {
+        const ShmRecord& record = entry.record;
+        if (!activeProducers.count(entry.producerID)) {
+            continue;
+        }
+
+        std::string sessionID = producerSessionID(entry.producerID);
+        auto key = std::make_pair(entry.producerID, record.clientKey);
+        auto it = notificationIDs.find(key);
+
+        try {
+            switch (record.op) {
+            case ShmOp::Create:
+                if (it == notificationIDs.end()) {
+                    PriorityEnum priority = record.priority <= 2 ? static_cast<PriorityEnum>(record.priority) : PriorityEnum::Normal;
+                    notificationIDs[key] = notificationManager.storeNotification(sessionID, entry.title, entry.message, priority, true);
+                    break;
+                }
+                [[fallthrough]];
+            case ShmOp::Update:
+                if (it != notificationIDs.end()) {
+                    nlohmann::json payload = nlohmann::json::object();
+                    if (!entry.title.empty()) payload["title"] = entry.title;
+                    if (!entry.message.empty()) payload["message"] = entry.message;
+                    notificationManager.updateNotification(sessionID, it->second, payload);
+                }
+                break;
+            case ShmOp::Remove:
+                if (it != notificationIDs.end()) {
+                    notificationManager.removeNotification(sessionID, it->second);
+                    notificationIDs.erase(it);
+                }
+                break;
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[ERROR] Failed to apply ingest record from producer " << entry.producerID << ": " << e.what() << std::endl;
+        }
+        ++recordsApplied;
+    }
+}
+
+void ShmIngest::handleLocalEviction(const std::string& sessionID, const std::string& notificationID) {
+    for (uint32_t producerID : activeProducers) {
+        if (producerSessionID(producerID) != sessionID) {
+            continue;
+        }
+        auto end = notificationIDs.lower_bound({ producerID + 1, 0 });
+        for (auto it = notificationIDs.lower_bound({ producerID, 0 }); it != end; ++it) {
+            if (it->second == notificationID) {
+                notificationIDs.erase(it);
+                return;
+            }
+        }
+        return;
+    }
+}
+
+void ShmIngest::removeProducer(uint32_t producerID) {
+    if (!activeProducers.erase(producerID)) {
+        return;
+    }
+    notificationIDs.erase(notificationIDs.lower_bound({ producerID, 0 }), notificationIDs.lower_bound({ producerID + 1, 0 }));
+    notificationManager.removeSession(producerSessionID(producerID));
+}
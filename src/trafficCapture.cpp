@@ -0,0 +1,101 @@
+#include "trafficCapture.h"
+#include <stdexcept>
+#include <cstring>
+
+namespace {
+    constexpr char CAPTURE_MAGIC[8] = { 'N', 'T', 'F', 'C', 'A', 'P', '0', '1' };
+    constexpr size_t RECORD_HEADER_SIZE = 8 + 4 + 1 + 4;
+
+    void appendLE(std::vector<char>& out, uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    uint64_t readLE(const unsigned char* in, size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+}
+
+TrafficCapture::TrafficCapture(const std::string& path)
+    : file(std::fopen(path.c_str(), "wb")), startTime(std::chrono::steady_clock::now()) {
+    if (!file) {
+        throw std::runtime_error("Failed to open capture file: " + path);
+    }
+    buffer.reserve(FLUSH_THRESHOLD * 2);
+    buffer.insert(buffer.end(), std::begin(CAPTURE_MAGIC), std::end(CAPTURE_MAGIC));
+}
+
+TrafficCapture::~TrafficCapture() {
+    flush();
+    std::fclose(file);
+}
+
+// Called on the event loop for every inbound frame: only appends to an in-memory
+// buffer, and touches the file once the buffer passes FLUSH_THRESHOLD.
+void TrafficCapture::record(uint32_t connectionID, CaptureKind kind, std::string_view payload) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime);
+
+    appendLE(buffer, static_cast<uint64_t>(elapsed.count()), 8);
+    appendLE(buffer, connectionID, 4);
+    buffer.push_back(static_cast<char>(kind));
+    appendLE(buffer, payload.size(), 4);
+    buffer.insert(buffer.end(), payload.begin(), payload.end());
+    ++recordCount;
+
+    if (buffer.size() >= FLUSH_THRESHOLD) {
+        flush();
+    }
+}
+
+void TrafficCapture::flush() {
+    if (!buffer.empty()) {
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+        buffer.clear();
+    }
+    std::fflush(file);
+}
+
+uint64_t TrafficCapture::getRecordCount() const {
+    return recordCount;
+}
+
+CaptureReader::CaptureReader(const std::string& path)
+    : file(std::fopen(path.c_str(), "rb")) {
+    if (!file) {
+        throw std::runtime_error("Failed to open capture file: " + path);
+    }
+
+    char magic[sizeof(CAPTURE_MAGIC)];
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) || std::memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) != 0) {
+        std::fclose(file);
+        throw std::runtime_error("Not a notifier capture file: " + path);
+    }
+}
+
+CaptureReader::~CaptureReader() {
+    std::fclose(file);
+}
+
+bool CaptureReader::next(CaptureRecord& record) {
+    unsigned char header[RECORD_HEADER_SIZE];
+    if (std::fread(header, 1, sizeof(header), file) != sizeof(header)) {
+        return false;
+    }
+
+    record.timestampNs = readLE(header, 8);
+    record.connectionID = static_cast<uint32_t>(readLE(header + 8, 4));
+    record.kind = static_cast<CaptureKind>(header[12]);
+    size_t length = static_cast<size_t>(readLE(header + 13, 4));
+
+    record.payload.resize(length);
+    if (length > 0 && std::fread(record.payload.data(), 1, length, file) != length) {
+        // A capture cut short by a crash ends with a partial record; stop there.
+        return false;
+    }
+    return true;
+}
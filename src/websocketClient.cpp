@@ -0,0 +1,307 @@
+#include "websocketClient.h"
+#include <stdexcept>
+#include <cstring>
+
+#ifdef _WIN32
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#define pollSockets WSAPoll
+#define closeSocket closesocket
+#define SEND_FLAGS 0
+static const SocketHandle INVALID_HANDLE = INVALID_SOCKET;
+#else
+#include <sys/socket.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <unistd.h>
+#define pollSockets poll
+#define closeSocket ::close
+#define SEND_FLAGS MSG_NOSIGNAL
+static const SocketHandle INVALID_HANDLE = -1;
+#endif
+
+namespace {
+    constexpr uint8_t OP_CONTINUATION = 0x0;
+    constexpr uint8_t OP_TEXT = 0x1;
+    constexpr uint8_t OP_BINARY = 0x2;
+    constexpr uint8_t OP_CLOSE = 0x8;
+    constexpr uint8_t OP_PING = 0x9;
+    constexpr uint8_t OP_PONG = 0xA;
+
+    std::string base64Encode(const unsigned char* data, size_t length) {
+        static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        for (size_t i = 0; i < length; i += 3) {
+            uint32_t chunk = data[i] << 16;
+            if (i + 1 < length) chunk |= data[i + 1] << 8;
+            if (i + 2 < length) chunk |= data[i + 2];
+            out += alphabet[(chunk >> 18) & 0x3F];
+            out += alphabet[(chunk >> 12) & 0x3F];
+            out += i + 1 < length ? alphabet[(chunk >> 6) & 0x3F] : '=';
+            out += i + 2 < length ? alphabet[chunk & 0x3F] : '=';
+        }
+        return out;
+    }
+
+#ifdef _WIN32
+    struct WinsockInit {
+        WinsockInit() {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+        ~WinsockInit() { WSACleanup(); }
+    };
+#endif
+}
+
+WebSocketClient::WebSocketClient()
+    : socketHandle(INVALID_HANDLE), maskGenerator(std::random_device{}()) {
+#ifdef _WIN32
+    static WinsockInit winsockInit;
+#endif
+}
+
+WebSocketClient::~WebSocketClient() {
+    close();
+}
+
+void WebSocketClient::connect(const std::string& host, int port, const std::string& path) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        throw std::runtime_error("Failed to resolve host: " + host);
+    }
+
+    for (addrinfo* address = addresses; address; address = address->ai_next) {
+        socketHandle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (socketHandle == INVALID_HANDLE) {
+            continue;
+        }
+        if (::connect(socketHandle, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0) {
+            break;
+        }
+        closeSocket(socketHandle);
+        socketHandle = INVALID_HANDLE;
+    }
+    freeaddrinfo(addresses);
+
+    if (socketHandle == INVALID_HANDLE) {
+        throw std::runtime_error("Failed to connect to " + host + ":" + std::to_string(port));
+    }
+
+    int noDelay = 1;
+    setsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+    unsigned char keyBytes[16];
+    for (auto& byte : keyBytes) {
+        byte = static_cast<unsigned char>(maskGenerator());
+    }
+
+    std::string request =
+        "GET " + path + " HTTP/1.1\r\n"
+        "Host: " + host + ":" + std::to_string(port) + "\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: " + base64Encode(keyBytes, sizeof(keyBytes)) + "\r\n"
+        "Sec-WebSocket-Version: 13\r\n\r\n";
+    sendAll(request.data(), request.size());
+
+    size_t headerEnd;
+    while ((headerEnd = readBuffer.find("\r\n\r\n")) == std::string::npos) {
+        readMore();
+    }
+    if (readBuffer.compare(0, 12, "HTTP/1.1 101") != 0) {
+        std::string statusLine = readBuffer.substr(0, readBuffer.find("\r\n"));
+        close();
+        throw std::runtime_error("WebSocket upgrade rejected: " + statusLine);
+    }
+    readBuffer.erase(0, headerEnd + 4);
+}
+
+void WebSocketClient::close() {
+    if (socketHandle == INVALID_HANDLE) {
+        return;
+    }
+    try {
+        const char normalClosure[2] = { 0x03, static_cast<char>(0xE8) }; // 1000
+        sendFrame(OP_CLOSE, std::string_view(normalClosure, sizeof(normalClosure)));
+    }
+    catch (const std::exception&) {
+        // The peer may already be gone; closing the socket is all that is left to do.
+    }
+    closeSocket(socketHandle);
+    socketHandle = INVALID_HANDLE;
+    readBuffer.clear();
+    fragmentBuffer.clear();
+}
+
+bool WebSocketClient::isOpen() const {
+    return socketHandle != INVALID_HANDLE;
+}
+
+void WebSocketClient::sendText(std::string_view message) {
+    sendFrame(OP_TEXT, message);
+}
+
+void WebSocketClient::sendBinary(std::string_view message) {
+    sendFrame(OP_BINARY, message);
+}
+
+bool WebSocketClient::receive(std::string& message, int timeoutMs) {
+    while (!parseFrame(message)) {
+        if (!waitReadable(timeoutMs)) {
+            return false;
+        }
+        readMore();
+    }
+    return true;
+}
+
+SocketHandle WebSocketClient::getHandle() const {
+    return socketHandle;
+}
+
+void WebSocketClient::sendFrame(uint8_t opCode, std::string_view payload) {
+    std::string frame;
+    frame.reserve(payload.size() + 14);
+    frame += static_cast<char>(0x80 | opCode);
+
+    // Client frames must always be masked.
+    if (payload.size() < 126) {
+        frame += static_cast<char>(0x80 | payload.size());
+    }
+    else if (payload.size() <= 0xFFFF) {
+        frame += static_cast<char>(0x80 | 126);
+        frame += static_cast<char>((payload.size() >> 8) & 0xFF);
+        frame += static_cast<char>(payload.size() & 0xFF);
+    }
+    else {
+        frame += static_cast<char>(0x80 | 127);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            frame += static_cast<char>((static_cast<uint64_t>(payload.size()) >> shift) & 0xFF);
+        }
+    }
+
+    uint32_t maskValue = maskGenerator();
+    char mask[4];
+    std::memcpy(mask, &maskValue, sizeof(mask));
+    frame.append(mask, sizeof(mask));
+
+    for (size_t i = 0; i < payload.size(); ++i) {
+        frame += static_cast<char>(payload[i] ^ mask[i & 3]);
+    }
+
+    sendAll(frame.data(), frame.size());
+}
+
+void WebSocketClient::sendAll(const char* data, size_t length) {
+    if (socketHandle == INVALID_HANDLE) {
+        throw std::runtime_error("WebSocket is not connected");
+    }
+    while (length > 0) {
+        auto sent = ::send(socketHandle, data, static_cast<int>(length), SEND_FLAGS);
+        if (sent <= 0) {
+            throw std::runtime_error("WebSocket send failed");
+        }
+        data += sent;
+        length -= static_cast<size_t>(sent);
+    }
+}
+
+bool WebSocketClient::waitReadable(int timeoutMs) {
+    if (socketHandle == INVALID_HANDLE) {
+        throw std::runtime_error("WebSocket is not connected");
+    }
+    pollfd descriptor{};
+    descriptor.fd = socketHandle;
+    descriptor.events = POLLIN;
+    return pollSockets(&descriptor, 1, timeoutMs) > 0;
+}
+
+void WebSocketClient::readMore() {
+    if (socketHandle == INVALID_HANDLE) {
+        throw std::runtime_error("WebSocket is not connected");
+    }
+    char chunk[16 * 1024];
+    auto received = ::recv(socketHandle, chunk, static_cast<int>(sizeof(chunk)), 0);
+    if (received <= 0) {
+        closeSocket(socketHandle);
+        socketHandle = INVALID_HANDLE;
+        throw std::runtime_error("WebSocket connection closed by peer");
+    }
+    readBuffer.append(chunk, static_cast<size_t>(received));
+}
+
+bool WebSocketClient::parseFrame(std::string& message) {
+    while (true) {
+        if (readBuffer.size() < 2) {
+            return false;
+        }
+
+        const auto* bytes = reinterpret_cast<const unsigned char*>(readBuffer.data());
+        bool finalFragment = bytes[0] & 0x80;
+        uint8_t opCode = bytes[0] & 0x0F;
+        bool masked = bytes[1] & 0x80;
+        uint64_t length = bytes[1] & 0x7F;
+        size_t offset = 2;
+
+        if (length == 126) {
+            if (readBuffer.size() < 4) return false;
+            length = (static_cast<uint64_t>(bytes[2]) << 8) | bytes[3];
+            offset = 4;
+        }
+        else if (length == 127) {
+            if (readBuffer.size() < 10) return false;
+            length = 0;
+            for (int i = 0; i < 8; ++i) {
+                length = (length << 8) | bytes[2 + i];
+            }
+            offset = 10;
+        }
+
+        size_t maskOffset = offset;
+        if (masked) {
+            offset += 4;
+        }
+        if (readBuffer.size() < offset + length) {
+            return false;
+        }
+
+        std::string payload = readBuffer.substr(offset, static_cast<size_t>(length));
+        if (masked) {
+            for (size_t i = 0; i < payload.size(); ++i) {
+                payload[i] ^= readBuffer[maskOffset + (i & 3)];
+            }
+        }
+        readBuffer.erase(0, offset + static_cast<size_t>(length));
+
+        switch (opCode) {
+        case OP_PING:
+            sendFrame(OP_PONG, payload);
+            continue;
+        case OP_PONG:
+            continue;
+        case OP_CLOSE:
+            closeSocket(socketHandle);
+            socketHandle = INVALID_HANDLE;
+            throw std::runtime_error("WebSocket connection closed by peer");
+        case OP_TEXT:
+        case OP_BINARY:
+        case OP_CONTINUATION:
+            fragmentBuffer += payload;
+            if (!finalFragment) {
+                continue;
+            }
+            message = std::move(fragmentBuffer);
+            fragmentBuffer.clear();
+            return true;
+        default:
+            throw std::runtime_error("Unsupported WebSocket opcode: " + std::to_string(opCode));
+        }
+    }
+}
@@ -1,27 +1,55 @@
 #include "websocketServer.h"
 #include <uwebsockets/App.h>
+#include <chrono>
 #include <iostream>
 #include <nlohmann/json.hpp>
 #include <stdexcept>
 #include <thread>
 
-WebSocketServer::WebSocketServer(NotificationManager& manager)
-    : port(9001), notificationManager(manager), keepRunning(true) {
+WebSocketServer::WebSocketServer(NotificationManager& manager, int port)
+    : port(port), notificationManager(manager), keepRunning(true) {
+    notificationManager.setEvictionListener([this](const std::string& sessionID, const std::string& notificationID) {
+        handleEviction(sessionID, notificationID);
+    });
+    mutationSubscription = notificationManager.getMutationLog().subscribe([this](const Mutation& mutation) {
+        handleMutation(mutation);
+    });
 }
 
 WebSocketServer::~WebSocketServer() {
+    notificationManager.setEvictionListener(nullptr);
+    notificationManager.getMutationLog().unsubscribe(mutationSubscription);
     stop();
     std::cout << "WebSocketServer destroyed." << std::endl;
 }
 
 void WebSocketServer::run() {
-    uWS::App()
-        .ws<UserData>("/*", {
+    uWS::App app;
+    if (leaderEnabled) {
+        app.ws<FollowerData>("/replicate", {
+            .maxBackpressure = 2 * MAX_FOLLOWER_BACKLOG,
+            .open = [this](uWS::WebSocket<false, true, FollowerData>* ws) {
+                followers.insert(ws);
+            },
+            .message = [this](uWS::WebSocket<false, true, FollowerData>* ws, std::string_view message, uWS::OpCode) {
+                handleFollowerSubscribe(ws, message);
+            },
+            .close = [this](uWS::WebSocket<false, true, FollowerData>* ws, int, std::string_view) {
+                followers.erase(ws);
+            }
+        });
+    }
+    app.ws<UserData>("/*", {
             .idleTimeout = 960,
+            .maxBackpressure = MAX_CLIENT_BACKPRESSURE,
             .open = [this](uWS::WebSocket<false, true, UserData>* ws) {
                 handleConnectionOpen(ws);
             },
             .message = [this](uWS::WebSocket<false, true, UserData>* ws, std::string_view message, uWS::OpCode opCode) {
+                if (capture) {
+                    capture->record(ws->getUserData()->connectionID,
+                        opCode == uWS::OpCode::BINARY ? CaptureKind::Binary : CaptureKind::Text, message);
+                }
                 if (opCode == uWS::OpCode::TEXT) {
                     handleMessage(std::string(message), ws);
                 }
@@ -40,8 +68,27 @@ void WebSocketServer::run() {
         else {
             throw std::runtime_error("Failed to listen on port " + std::to_string(port));
         }
-            })
-        .run();
+            });
+
+    struct us_timer_t* tickTimer = us_create_timer((struct us_loop_t*)uWS::Loop::get(), 0, sizeof(WebSocketServer*));
+    *static_cast<WebSocketServer**>(us_timer_ext(tickTimer)) = this;
+    us_timer_set(tickTimer, [](struct us_timer_t* timer) {
+        (*static_cast<WebSocketServer**>(us_timer_ext(timer)))->handleTimerTick();
+        }, TICK_INTERVAL_MS, TICK_INTERVAL_MS);
+
+    if (!leaderHost.empty()) {
+        follower = std::make_unique<ReplicationFollower>(leaderHost, leaderPort, notificationManager, uWS::Loop::get());
+        follower->start();
+    }
+
+#ifdef __linux__
+    if (!shmSocketPath.empty()) {
+        shmIngest = std::make_unique<ShmIngest>(shmSocketPath, SHM_RING_CAPACITY, notificationManager, uWS::Loop::get());
+        shmIngest->start();
+    }
+#endif
+
+    app.run();
 
     while (keepRunning) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -50,14 +97,207 @@ void WebSocketServer::run() {
     std::cout << "WebSocket server stopped gracefully." << std::endl;
 }
 
+void WebSocketServer::enableCapture(const std::string& path) {
+    capture = std::make_unique<TrafficCapture>(path);
+    std::cout << "[INFO] Capturing inbound traffic to " << path << std::endl;
+}
+
+void WebSocketServer::enableLeader() {
+    leaderEnabled = true;
+    notificationManager.getMutationLog().setRetained(true);
+    updateMutationRecording();
+    std::cout << "[INFO] Serving replication on ws://localhost:" << port << "/replicate" << std::endl;
+}
+
+void WebSocketServer::enableFollower(const std::string& host, int hostPort) {
+    leaderHost = host;
+    leaderPort = hostPort;
+    std::cout << "[INFO] Following leader at " << host << ":" << hostPort << std::endl;
+}
+
+#ifdef __linux__
+void WebSocketServer::enableShmIngest(const std::string& socketPath) {
+    shmSocketPath = socketPath;
+}
+#endif
+
+void WebSocketServer::handleFollowerSubscribe(uWS::WebSocket<false, true, FollowerData>* ws, std::string_view message) {
+    try {
+        auto json = nlohmann::json::parse(message);
+        if (json.value("action", "") != "subscribe") {
+            throw std::runtime_error("Expected a subscribe request");
+        }
+
+        MutationLog& log = notificationManager.getMutationLog();
+        std::string logID = json.value("logID", "");
+        uint64_t fromSequence = json.value("fromSequence", uint64_t{ 0 });
+
+        std::vector<Mutation> backlog;
+        if (logID == log.getLogID() && log.readFrom(fromSequence, backlog)) {
+            for (const auto& mutation : backlog) {
+                nlohmann::json frame = mutationToJson(mutation);
+                frame["type"] = "mutation";
+                ws->send(frame.dump(), uWS::OpCode::TEXT);
+            }
+        }
+        else {
+            nlohmann::json entries = nlohmann::json::array();
+            for (const auto& entry : notificationManager.snapshotNotifications()) {
+                entries.push_back(mutationToJson(entry));
+            }
+            nlohmann::json snapshot = { {"type", "snapshot"}, {"logID", log.getLogID()},
+                {"sequence", log.getLastSequence()}, {"notifications", entries} };
+            ws->send(snapshot.dump(), uWS::OpCode::TEXT);
+        }
+
+        ws->getUserData()->subscribed = true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[ERROR] Invalid replication request: " << e.what() << std::endl;
+        ws->end(1008, e.what());
+    }
+}
+
+void WebSocketServer::handleMutation(const Mutation& mutation) {
+    if (followers.empty() && watchers.empty()) {
+        return;
+    }
+
+    nlohmann::json frame = mutationToJson(mutation);
+    if (!followers.empty()) {
+        frame["type"] = "mutation";
+        sendToFollowers(frame.dump());
+        frame.erase("type");
+    }
+    if (!watchers.empty()) {
+        // Watchers see budget evictions as notifications that expired.
+        frame["event"] = "delta";
+        if (mutation.type == MutationType::Evicted) {
+            frame["op"] = "expired";
+        }
+        sendToWatchers(frame.dump());
+    }
+}
+
+// Serialises once for all followers. A follower that falls too far behind is disconnected
+// rather than buffered without bound; it resumes from its last sequence when it reconnects.
+void WebSocketServer::sendToFollowers(const std::string& frame) {
+    std::vector<uWS::WebSocket<false, true, FollowerData>*> lagging;
+    for (auto* ws : followers) {
+        if (!ws->getUserData()->subscribed) {
+            continue;
+        }
+        if (ws->getBufferedAmount() > MAX_FOLLOWER_BACKLOG) {
+            lagging.push_back(ws);
+            continue;
+        }
+        ws->send(frame, uWS::OpCode::TEXT);
+    }
+
+    for (auto* ws : lagging) {
+        std::cerr << "[WARNING] Disconnecting replication follower that fell behind." << std::endl;
+        ws->end(1013, "Follower too far behind");
+    }
+}
+
+nlohmann::json WebSocketServer::buildWatchSnapshot() const {
+    nlohmann::json entries = nlohmann::json::array();
+    for (const auto& entry : notificationManager.snapshotNotifications()) {
+        entries.push_back({ {"notificationID", entry.notificationID}, {"sessionID", entry.sessionID},
+            {"title", entry.title}, {"message", entry.message}, {"priority", priorityToString(entry.priority)} });
+    }
+    return { {"sequence", notificationManager.getMutationLog().getLastSequence()}, {"notifications", entries} };
+}
+
+// Serialises once for all watchers. A watcher whose send buffer has grown past
+// MAX_WATCHER_BACKLOG stops receiving deltas and is sent a fresh snapshot once it
+// has drained (see resyncWatchers), so nothing is buffered without bound.
+void WebSocketServer::sendToWatchers(const std::string& frame) {
+    for (auto* ws : watchers) {
+        auto* userData = ws->getUserData();
+        if (userData->resyncPending) {
+            continue;
+        }
+        if (ws->getBufferedAmount() > MAX_WATCHER_BACKLOG || ws->send(frame, uWS::OpCode::TEXT) == uWS::WebSocket<false, true, UserData>::DROPPED) {
+            userData->resyncPending = true;
+        }
+    }
+}
+
+void WebSocketServer::resyncWatchers() {
+    std::string snapshot;
+    for (auto* ws : watchers) {
+        auto* userData = ws->getUserData();
+        if (!userData->resyncPending || ws->getBufferedAmount() > MAX_WATCHER_BACKLOG / 4) {
+            continue;
+        }
+        if (snapshot.empty()) {
+            nlohmann::json frame = buildWatchSnapshot();
+            frame["event"] = "snapshot";
+            snapshot = frame.dump();
+        }
+        ws->send(snapshot, uWS::OpCode::TEXT);
+        userData->resyncPending = false;
+        ++watcherResyncs;
+    }
+}
+
+void WebSocketServer::updateMutationRecording() {
+    notificationManager.setMutationRecording(leaderEnabled || !watchers.empty());
+}
+
+void WebSocketServer::handleEviction(const std::string& sessionID, const std::string& notificationID) {
+    if (follower) {
+        follower->handleLocalEviction(sessionID, notificationID);
+    }
+#ifdef __linux__
+    if (shmIngest) {
+        shmIngest->handleLocalEviction(sessionID, notificationID);
+    }
+#endif
+
+    auto it = activeConnections.find(sessionID);
+    if (it == activeConnections.end() || !it->second) {
+        return;
+    }
+
+    nlohmann::json event = { {"event", "evicted"}, {"sessionID", sessionID},
+        {"payload", {{"notificationID", notificationID}, {"reason", "memory budget exceeded"}}} };
+    it->second->send(event.dump(), uWS::OpCode::TEXT);
+}
+
+void WebSocketServer::handleTimerTick() {
+    notificationManager.flushDueDigests();
+    if (!followers.empty()) {
+        const MutationLog& log = notificationManager.getMutationLog();
+        nlohmann::json heartbeat = { {"type", "heartbeat"}, {"logID", log.getLogID()}, {"sequence", log.getLastSequence()},
+            {"timestampMs", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count()} };
+        sendToFollowers(heartbeat.dump());
+    }
+    resyncWatchers();
+    if (capture) {
+        capture->flush();
+    }
+}
+
 void WebSocketServer::stop() {
     keepRunning = false;
+    if (follower) {
+        follower->stop();
+    }
+#ifdef __linux__
+    if (shmIngest) {
+        shmIngest->stop();
+    }
+#endif
     for (auto& [sessionID, ws] : activeConnections) {
         if (ws) {
             ws->close();
         }
     }
     activeConnections.clear();
+    watchers.clear();
+    updateMutationRecording();
     std::cout << "All WebSocket connections closed." << std::endl;
 }
 
@@ -90,6 +330,11 @@ void WebSocketServer::handleConnectionOpen(uWS::WebSocket<false, true, UserData>
     auto* userData = ws->getUserData();
     std::string sessionID = generateSessionID();
     userData->sessionID = sessionID;
+    userData->connectionID = nextConnectionID++;
+
+    if (capture) {
+        capture->record(userData->connectionID, CaptureKind::Open);
+    }
 
     activeConnections[sessionID] = ws;
     notificationManager.addSession(sessionID);
@@ -101,6 +346,12 @@ void WebSocketServer::handleConnectionOpen(uWS::WebSocket<false, true, UserData>
 void WebSocketServer::handleConnectionClose(uWS::WebSocket<false, true, UserData>* ws, int code, std::string_view message) {
     auto* userData = ws->getUserData();
     std::string sessionID = userData->sessionID;
+    watchers.erase(ws);
+    updateMutationRecording();
+
+    if (capture) {
+        capture->record(userData->connectionID, CaptureKind::Close, message);
+    }
 
     if (code != 1000) {
         std::cerr << "[Warning] Unexpected Websocket disconnection. Code: " << code
@@ -116,65 +367,153 @@ void WebSocketServer::handleConnectionClose(uWS::WebSocket<false, true, UserData
 }
 
 void WebSocketServer::handleMessage(const std::string& message, uWS::WebSocket<false, true, UserData>* ws) {
+    using ActionHandler = std::function<nlohmann::json(WebSocketServer&, const std::string&, const nlohmann::json&)>;
+
+    static const std::unordered_map<std::string, ActionHandler> actionHandlers = {
+        {"registerTemplate", [](WebSocketServer& server, const std::string& sessionID, const nlohmann::json& payload) -> nlohmann::json {
+            std::string templateID = payload.at("templateID");
+            size_t parameterCount = server.notificationManager.registerTemplate(sessionID, templateID,
+                payload.value("title", ""), payload.value("message", ""));
+            return { {"action", "registerTemplate"}, {"templateID", templateID}, {"parameters", parameterCount} };
+        }},
+        {"create", [](WebSocketServer& server, const std::string& sessionID, const nlohmann::json& payload) -> nlohmann::json {
+            std::string notificationID = server.notificationManager.createNotification(sessionID, payload);
+            return { {"action", "create"}, {"notificationID", notificationID} };
+        }},
+        {"update", [](WebSocketServer& server, const std::string& sessionID, const nlohmann::json& payload) -> nlohmann::json {
+            server.notificationManager.updateNotification(sessionID, payload.at("notificationID"), payload);
+            return { {"action", "update"}, {"notificationID", payload.at("notificationID")} };
+        }},
+        {"delete", [](WebSocketServer& server, const std::string& sessionID, const nlohmann::json& payload) -> nlohmann::json {
+            server.notificationManager.removeNotification(sessionID, payload.at("notificationID"));
+            return { {"action", "delete"}, {"notificationID", payload.at("notificationID")} };
+        }},
+        {"display", [](WebSocketServer& server, const std::string& sessionID, const nlohmann::json& payload) -> nlohmann::json {
+            server.notificationManager.displayNotification(sessionID, payload.at("notificationID"));
+            return { {"action", "display"}, {"notificationID", payload.at("notificationID")} };
+        }},
+        {"displayAll", [](WebSocketServer& server, const std::string& sessionID, const nlohmann::json&) -> nlohmann::json {
+            server.notificationManager.displayAllNotifications(sessionID);
+            return { "action", "displayAll" };
+        }},
+        {"stats", [](WebSocketServer& server, const std::string&, const nlohmann::json&) -> nlohmann::json {
+            nlohmann::json stats = { {"action", "stats"} };
+            if (auto dedup = server.notificationManager.getDedupStats()) {
+                stats["dedup"] = { {"hits", dedup->hits}, {"misses", dedup->misses}, {"evictions", dedup->evictions},
+                    {"entries", dedup->entries}, {"capacity", dedup->capacity}, {"memoryBytes", dedup->memoryBytes} };
+            }
+            MemoryStats memory = server.notificationManager.getMemoryStats();
+            stats["memory"] = { {"totalBytes", memory.totalBytes}, {"globalBudget", memory.globalBudget},
+                {"sessionBudget", memory.sessionBudget}, {"evictions", memory.evictions}, {"sessionBytes", memory.sessionBytes} };
+            if (auto digest = server.notificationManager.getDigestStats()) {
+                stats["digest"] = { {"notificationsDigested", digest->notificationsDigested}, {"digestsDelivered", digest->digestsDelivered},
+                    {"deliveriesSaved", digest->deliveriesSaved}, {"pendingNotifications", digest->pendingNotifications} };
+            }
+            if (server.leaderEnabled) {
+                stats["replication"] = { {"role", "leader"}, {"sequence", server.notificationManager.getMutationLog().getLastSequence()},
+                    {"followers", server.followers.size()},
+                    {"retainedLogBytes", server.notificationManager.getMutationLog().getRetainedBytes()} };
+            }
+            else if (server.follower) {
+                ReplicationStatus status = server.follower->getStatus();
+                stats["replication"] = { {"role", "follower"}, {"connected", status.connected},
+                    {"leaderSequence", status.leaderSequence}, {"appliedSequence", status.appliedSequence},
+                    {"sequenceLag", status.leaderSequence - std::min(status.leaderSequence, status.appliedSequence)},
+                    {"lagMs", status.lagMs}, {"snapshotsApplied", status.snapshotsApplied} };
+            }
+#ifdef __linux__
+            if (server.shmIngest) {
+                ShmIngestStats ingest = server.shmIngest->getStats();
+                stats["shmIngest"] = { {"recordsApplied", ingest.recordsApplied}, {"batchesApplied", ingest.batchesApplied},
+                    {"producersConnected", ingest.producersConnected}, {"ringCapacity", ingest.ringCapacity} };
+            }
+#endif
+            stats["watch"] = { {"watchers", server.watchers.size()}, {"resyncs", server.watcherResyncs} };
+            stats["requests"] = { {"handled", server.requestTiming.handled}, {"parseNanoseconds", server.requestTiming.parseNanoseconds},
+                {"handleNanoseconds", server.requestTiming.handleNanoseconds} };
+            return stats;
+        }},
+        {"watch", [](WebSocketServer& server, const std::string& sessionID, const nlohmann::json&) -> nlohmann::json {
+            auto it = server.activeConnections.find(sessionID);
+            if (it == server.activeConnections.end() || !it->second) {
+                throw std::runtime_error("Session is not connected");
+            }
+            it->second->getUserData()->resyncPending = false;
+            server.watchers.insert(it->second);
+            server.updateMutationRecording();
+
+            // Deltas with a higher sequence than the snapshot follow as "delta" events.
+            nlohmann::json payload = server.buildWatchSnapshot();
+            payload["action"] = "watch";
+            return payload;
+        }},
+        {"unwatch", [](WebSocketServer& server, const std::string& sessionID, const nlohmann::json&) -> nlohmann::json {
+            if (auto it = server.activeConnections.find(sessionID); it != server.activeConnections.end()) {
+                server.watchers.erase(it->second);
+                server.updateMutationRecording();
+            }
+            return { {"action", "unwatch"} };
+        }},
+        {"ping", [](WebSocketServer&, const std::string&, const nlohmann::json&) -> nlohmann::json {
+            return { "action", "pong" };
+        }},
+    };
+
+    // Echoed back in every response, success or error, so clients can pipeline requests.
+    nlohmann::json requestId;
+    std::string action;
+    auto receivedAt = std::chrono::steady_clock::now();
+    auto parsedAt = receivedAt;
+
     try {
         auto json = nlohmann::json::parse(message);
+        parsedAt = std::chrono::steady_clock::now();
+
+        if (json.contains("requestId")) {
+            requestId = json["requestId"];
+            if (!requestId.is_string() && !requestId.is_number()) {
+                requestId = nullptr;
+                throw std::runtime_error("[Error] Invalid message format: requestId must be a string or number");
+            }
+        }
 
         if (!json.contains("sessionID") || !json.contains("action")) {
             throw std::runtime_error("[Error] Invalid message format: Missing sessionID or action");
         }
 
         std::string sessionID = json["sessionID"];
-        std::string action = json["action"];
+        action = json["action"];
         auto* userData = ws->getUserData();
 
         if (userData->sessionID != sessionID) {
             throw std::runtime_error("Unauthorized session ID");
         }
 
-        static const std::unordered_map<std::string, std::function<void(const nlohmann::json&)>> actionHandlers = {
-            {"create", [this, sessionID, ws](const nlohmann::json& payload) {
-                std::string notificationID = notificationManager.createNotification(sessionID, payload);
-                nlohmann::json response = { {"status", "success"}, {"sessionID", sessionID}, {"payload", {{"action", "create"}, {"notificationID", notificationID}}} };
-                ws->send(response.dump(), uWS::OpCode::TEXT);
-            }},
-            {"update", [this, sessionID, ws](const nlohmann::json& payload) {
-                notificationManager.updateNotification(sessionID, payload["notificationID"], payload);
-                nlohmann::json response = { {"status", "success"}, {"sessionID", sessionID}, {"payload", {{"action", "update"}, {"notificationID", payload["notificationID"]}}} };
-                ws->send(response.dump(), uWS::OpCode::TEXT);
-            }},
-            {"delete", [this, sessionID, ws](const nlohmann::json& payload) {
-                notificationManager.removeNotification(sessionID, payload["notificationID"]);
-                nlohmann::json response = { {"status", "success"}, {"sessionID", sessionID}, {"payload", {{"action", "delete"}, {"notificationID", payload["notificationID"]}} } };
-                ws->send(response.dump(), uWS::OpCode::TEXT);
-            }},
-            {"display", [this, sessionID, ws](const nlohmann::json& payload) {
-                notificationManager.displayNotification(sessionID, payload["notificationID"]);
-                nlohmann::json response = { {"status", "success"}, {"sessionID", sessionID}, {"payload", {{"action", "display"}, {"notificationID", payload["notificationID"]}}} };
-                ws->send(response.dump(), uWS::OpCode::TEXT);
-            }},
-            {"displayAll", [this, sessionID, ws](const nlohmann::json&) {
-                notificationManager.displayAllNotifications(sessionID);
-                nlohmann::json response = { {"status", "success"}, {"sessionID", sessionID}, {"payload", {"action", "displayAll"}} };
-                ws->send(response.dump(), uWS::OpCode::TEXT);
-            }},
-            {"ping", [this, sessionID, ws](const nlohmann::json& payload) {
-                nlohmann::json response = {{"status", "success"}, {"sessionID", sessionID}, {"payload", {"action", "pong"}}};
-                ws->send(response.dump(), uWS::OpCode::TEXT);
-            }},
-        };
-
         auto it = actionHandlers.find(action);
-        if (it != actionHandlers.end()) {
-            it->second(json["payload"]);
-        }
-        else {
+        if (it == actionHandlers.end()) {
             throw std::runtime_error("Unknown action: " + action);
         }
 
+        nlohmann::json response = { {"status", "success"}, {"sessionID", sessionID}, {"payload", it->second(*this, sessionID, json["payload"])} };
+        if (!requestId.is_null()) {
+            response["requestId"] = requestId;
+        }
+        ws->send(response.dump(), uWS::OpCode::TEXT);
     }
     catch (const std::exception& e) {
         std::cerr << "[ERROR] Exception in handleMessage: " << e.what() << std::endl;
         nlohmann::json errorResponse = { {"status", "error"}, {"message", e.what()} };
+        if (!requestId.is_null()) {
+            errorResponse["requestId"] = requestId;
+        }
+        if (!action.empty()) {
+            errorResponse["action"] = action;
+        }
         ws->send(errorResponse.dump(), uWS::OpCode::TEXT);
     }
+
+    auto finishedAt = std::chrono::steady_clock::now();
+    ++requestTiming.handled;
+    requestTiming.parseNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(parsedAt - receivedAt).count();
+    requestTiming.handleNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(finishedAt - parsedAt).count();
 }
@@ -0,0 +1,275 @@
+// Load benchmark for a running notifier. Sends the same request stream twice over one
+// connection: first strictly one request at a time, then pipelined with up to --window
+// requests in flight matched back by requestId, and reports the throughput gain along
+// with the average request size. Each phase also reads the notifier's request timers from
+// 'stats' before and after, and reports the server's JSON parse and handling time per
+// request.
+//
+// 'update' and 'update-template' produce the same rendered notification text, so
+// comparing the two shows what server-side templates save per message.
+//
+// Usage: notifier_bench [--host <host>] [--port <port>] [--requests <n>] [--window <n>] [--action ping|update|update-template]
+
+#include "websocketClient.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+    std::string host = "localhost";
+    int port = 9001;
+    size_t requests = 20000;
+    size_t window = 256;
+    std::string action = "ping";
+};
+
+struct PhaseResult {
+    double seconds = 0;
+    size_t errors = 0;
+    size_t bytesSent = 0;
+    std::vector<double> latenciesUs;
+    double serverParseUs = 0;
+    double serverHandleUs = 0;
+};
+
+struct ServerTiming {
+    uint64_t handled = 0;
+    uint64_t parseNanoseconds = 0;
+    uint64_t handleNanoseconds = 0;
+};
+constexpr const char* QUOTE_TITLE = "Market data: {0}";
+constexpr const char* QUOTE_MESSAGE = "Last {1} | Change {2} | Volume {3} | Exchange NASDAQ | Delayed quote, not for trading decisions";
+
+static std::vector<std::string> quoteParameters(uint64_t tick) {
+    return { "AAPL", std::to_string(189 + tick % 7) + "." + std::to_string(10 + tick % 90),
+        (tick % 2 ? "+" : "-") + std::to_string(tick % 300) + "bp", std::to_string(1000000 + tick * 37) };
+}
+
+static std::string renderQuote(const std::string& pattern, const std::vector<std::string>& parameters) {
+    std::string text = pattern;
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        std::string placeholder = "{" + std::to_string(i) + "}";
+        if (size_t position = text.find(placeholder); position != std::string::npos) {
+            text.replace(position, placeholder.size(), parameters[i]);
+        }
+    }
+    return text;
+}
+
+static void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [--host <host>] [--port <port>] [--requests <n>] [--window <n>]\n"
+        << "       [--action ping|update|update-template]\n"
+        << "  --requests <n>   Requests per phase (default 20000)\n"
+        << "  --window <n>     Requests in flight during the pipelined phase (default 256)\n"
+        << "  --action <name>  'ping', 'update' to rewrite one low-priority notification, or 'update-template'\n"
+        << "                   to send the same updates as template parameters (default ping)\n";
+}
+
+static bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--host" && i + 1 < argc) {
+            options.host = argv[++i];
+        }
+        else if (arg == "--port" && i + 1 < argc) {
+            options.port = std::stoi(argv[++i]);
+        }
+        else if (arg == "--requests" && i + 1 < argc) {
+            options.requests = std::stoul(argv[++i]);
+        }
+        else if (arg == "--window" && i + 1 < argc) {
+            options.window = std::stoul(argv[++i]);
+        }
+        else if (arg == "--action" && i + 1 < argc) {
+            options.action = argv[++i];
+        }
+        else {
+            return false;
+        }
+    }
+    return options.requests > 0 && options.window > 0 &&
+        (options.action == "ping" || options.action == "update" || options.action == "update-template");
+}
+
+static nlohmann::json awaitResponse(WebSocketClient& client) {
+    std::string message;
+    while (client.receive(message, 5000)) {
+        auto json = nlohmann::json::parse(message);
+        if (json.contains("status")) {
+            return json;
+        }
+    }
+    throw std::runtime_error("Timed out waiting for a response");
+}
+
+static PhaseResult runPhase(WebSocketClient& client, const std::string& sessionID, const std::string& notificationID,
+    const BenchOptions& options, size_t window, uint64_t firstRequestId) {
+    PhaseResult result;
+    result.latenciesUs.reserve(options.requests);
+    std::unordered_map<uint64_t, Clock::time_point> inFlight;
+
+    bool templated = options.action == "update-template";
+    nlohmann::json request = { {"sessionID", sessionID}, {"action", templated ? "update" : options.action}, {"payload", nlohmann::json::object()} };
+    if (options.action != "ping") {
+        request["payload"] = { {"notificationID", notificationID} };
+    }
+
+    size_t sent = 0;
+    size_t received = 0;
+    auto start = Clock::now();
+
+    while (received < options.requests) {
+        while (sent < options.requests && inFlight.size() < window) {
+            uint64_t requestId = firstRequestId + sent;
+            request["requestId"] = requestId;
+            if (options.action == "update") {
+                auto parameters = quoteParameters(requestId);
+                request["payload"]["title"] = renderQuote(QUOTE_TITLE, parameters);
+                request["payload"]["message"] = renderQuote(QUOTE_MESSAGE, parameters);
+            }
+            else if (templated) {
+                request["payload"]["params"] = quoteParameters(requestId);
+            }
+            std::string frame = request.dump();
+            inFlight[requestId] = Clock::now();
+            client.sendText(frame);
+            result.bytesSent += frame.size();
+            ++sent;
+        }
+
+        nlohmann::json response = awaitResponse(client);
+        auto receivedAt = Clock::now();
+        if (!response.contains("requestId")) {
+            throw std::runtime_error("Response without requestId: " + response.dump());
+        }
+
+        auto it = inFlight.find(response["requestId"].get<uint64_t>());
+        if (it == inFlight.end()) {
+            throw std::runtime_error("Response for unknown requestId: " + response.dump());
+        }
+        result.latenciesUs.push_back(std::chrono::duration<double, std::micro>(receivedAt - it->second).count());
+        inFlight.erase(it);
+        if (response["status"] != "success") {
+            ++result.errors;
+        }
+        ++received;
+    }
+
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::sort(result.latenciesUs.begin(), result.latenciesUs.end());
+    return result;
+}
+
+static ServerTiming fetchServerTiming(WebSocketClient& client, const std::string& sessionID) {
+    nlohmann::json request = { {"sessionID", sessionID}, {"action", "stats"}, {"requestId", "stats"}, {"payload", nlohmann::json::object()} };
+    client.sendText(request.dump());
+    nlohmann::json timing = awaitResponse(client).at("payload").at("requests");
+    return { timing.at("handled"), timing.at("parseNanoseconds"), timing.at("handleNanoseconds") };
+}
+
+// Runs a phase between two stats snapshots. The difference includes the first stats
+// request, which is noise next to the phase's own requests.
+static PhaseResult runMeasuredPhase(WebSocketClient& client, const std::string& sessionID, const std::string& notificationID,
+    const BenchOptions& options, size_t window, uint64_t firstRequestId) {
+    ServerTiming before = fetchServerTiming(client, sessionID);
+    PhaseResult result = runPhase(client, sessionID, notificationID, options, window, firstRequestId);
+    ServerTiming after = fetchServerTiming(client, sessionID);
+
+    double handled = static_cast<double>(std::max<uint64_t>(1, after.handled - before.handled));
+    result.serverParseUs = (after.parseNanoseconds - before.parseNanoseconds) / handled / 1000;
+    result.serverHandleUs = (after.handleNanoseconds - before.handleNanoseconds) / handled / 1000;
+    return result;
+}
+
+static void printPhase(const std::string& name, const PhaseResult& result) {
+    auto percentile = [&](double fraction) {
+        return result.latenciesUs[static_cast<size_t>(fraction * (result.latenciesUs.size() - 1))];
+    };
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed
+        << std::setw(12) << std::setprecision(0) << result.latenciesUs.size() / result.seconds
+        << std::setw(12) << std::setprecision(1) << percentile(0.50)
+        << std::setw(12) << percentile(0.99)
+        << std::setw(10) << result.errors
+        << std::setw(14) << std::setprecision(2) << result.serverParseUs
+        << std::setw(15) << result.serverHandleUs << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        WebSocketClient client;
+        client.connect(options.host, options.port);
+
+        std::string greeting;
+        if (!client.receive(greeting, 5000)) {
+            throw std::runtime_error("Timed out waiting for session assignment");
+        }
+        std::string sessionID = nlohmann::json::parse(greeting).at("sessionID");
+
+        std::string notificationID;
+        if (options.action == "update-template") {
+            nlohmann::json registration = { {"sessionID", sessionID}, {"action", "registerTemplate"}, {"requestId", "setup"},
+                {"payload", {{"templateID", "quote"}, {"title", QUOTE_TITLE}, {"message", QUOTE_MESSAGE}}} };
+            client.sendText(registration.dump());
+            nlohmann::json response = awaitResponse(client);
+            if (response["status"] != "success") {
+                throw std::runtime_error("registerTemplate failed: " + response.dump());
+            }
+        }
+        if (options.action != "ping") {
+            nlohmann::json payload = { {"title", "notifier_bench"}, {"message", "starting"}, {"priority", "low"} };
+            if (options.action == "update-template") {
+                payload = { {"templateID", "quote"}, {"params", quoteParameters(0)}, {"priority", "low"} };
+            }
+            nlohmann::json create = { {"sessionID", sessionID}, {"action", "create"}, {"requestId", "setup"}, {"payload", payload} };
+            client.sendText(create.dump());
+            notificationID = awaitResponse(client).at("payload").at("notificationID");
+        }
+
+        std::cout << "Benchmarking '" << options.action << "' with " << options.requests << " requests per phase\n\n"
+            << std::left << std::setw(22) << "mode" << std::right << std::setw(12) << "req/s"
+            << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(10) << "errors"
+            << std::setw(14) << "srv parse us" << std::setw(15) << "srv handle us" << "\n";
+
+        PhaseResult strict = runMeasuredPhase(client, sessionID, notificationID, options, 1, 0);
+        printPhase("strict (window 1)", strict);
+
+        PhaseResult pipelined = runMeasuredPhase(client, sessionID, notificationID, options, options.window, options.requests);
+        printPhase("pipelined (window " + std::to_string(options.window) + ")", pipelined);
+
+        std::cout << "\nPipelining throughput gain: " << std::setprecision(2) << strict.seconds / pipelined.seconds << "x\n"
+            << "Average request size:       " << std::setprecision(0) << static_cast<double>(strict.bytesSent) / options.requests << " bytes\n";
+
+        if (!notificationID.empty()) {
+            nlohmann::json remove = { {"sessionID", sessionID}, {"action", "delete"}, {"requestId", "teardown"},
+                {"payload", {{"notificationID", notificationID}}} };
+            client.sendText(remove.dump());
+            awaitResponse(client);
+        }
+        client.close();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
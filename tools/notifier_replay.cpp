@@ -0,0 +1,295 @@
+// Replays a capture recorded with `notifier --capture <file>` against a running notifier
+// and reports per-action latency percentiles.
+//
+// Usage: notifier_replay <capture file> [--host <host>] [--port <port>] [--speed <factor> | --asap]
+//
+// Each captured connection is reopened and the sessionID in every replayed message is
+// rewritten to the one the server assigns. Notification IDs are replayed verbatim; they
+// line up with the original run as long as the server starts from an empty state.
+
+#include "trafficCapture.h"
+#include "websocketClient.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#define pollSockets WSAPoll
+#else
+#include <poll.h>
+#define pollSockets poll
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+struct PendingRequest {
+    std::string action;
+    Clock::time_point sentAt;
+};
+
+struct ReplayConnection {
+    WebSocketClient client;
+    std::string sessionID;
+    std::deque<PendingRequest> inFlight;
+    bool closing = false;
+};
+
+struct ReplayOptions {
+    std::string capturePath;
+    std::string host = "localhost";
+    int port = 9001;
+    double speed = 1.0;  // 0 replays as fast as possible
+};
+
+static void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " <capture file> [--host <host>] [--port <port>] [--speed <factor> | --asap]\n"
+        << "  --speed <factor>   Replay at <factor> times the captured pace (default 1)\n"
+        << "  --asap             Ignore captured timing and send as fast as possible\n";
+}
+
+static bool parseOptions(int argc, char* argv[], ReplayOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--host" && i + 1 < argc) {
+            options.host = argv[++i];
+        }
+        else if (arg == "--port" && i + 1 < argc) {
+            options.port = std::stoi(argv[++i]);
+        }
+        else if (arg == "--speed" && i + 1 < argc) {
+            options.speed = std::stod(argv[++i]);
+        }
+        else if (arg == "--asap") {
+            options.speed = 0;
+        }
+        else if (options.capturePath.empty() && arg.rfind("--", 0) != 0) {
+            options.capturePath = arg;
+        }
+        else {
+            return false;
+        }
+    }
+    return !options.capturePath.empty() && options.speed >= 0;
+}
+
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+int main(int argc, char* argv[]) {
+    ReplayOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::mutex mutex;
+    std::unordered_map<uint32_t, std::unique_ptr<ReplayConnection>> connections;
+    std::map<std::string, std::vector<double>> latenciesUs;
+    std::atomic<bool> receiving(true);
+    uint64_t unmatchedResponses = 0;
+
+    // Responses come back in request order on each connection, so the oldest in-flight
+    // request of that connection is the one being answered.
+    std::thread receiver([&]() {
+        while (receiving.load()) {
+            std::vector<ReplayConnection*> open;
+            std::vector<pollfd> descriptors;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto& [connectionID, connection] : connections) {
+                    if (connection->client.isOpen()) {
+                        open.push_back(connection.get());
+                        descriptors.push_back({ connection->client.getHandle(), POLLIN, 0 });
+                    }
+                }
+            }
+
+            if (descriptors.empty()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            if (pollSockets(descriptors.data(), static_cast<unsigned long>(descriptors.size()), 10) <= 0) {
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < descriptors.size(); ++i) {
+                if (!descriptors[i].revents) {
+                    continue;
+                }
+                ReplayConnection* connection = open[i];
+                try {
+                    std::string message;
+                    while (connection->client.isOpen() && connection->client.receive(message, 0)) {
+                        auto receivedAt = Clock::now();
+                        auto json = nlohmann::json::parse(message, nullptr, false);
+                        if (json.is_discarded() || !json.contains("status")) {
+                            continue;
+                        }
+                        if (connection->inFlight.empty()) {
+                            ++unmatchedResponses;
+                            continue;
+                        }
+                        const PendingRequest& request = connection->inFlight.front();
+                        latenciesUs[request.action].push_back(
+                            std::chrono::duration<double, std::micro>(receivedAt - request.sentAt).count());
+                        connection->inFlight.pop_front();
+                    }
+                    if (connection->closing && connection->inFlight.empty()) {
+                        connection->client.close();
+                    }
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "[WARNING] Connection " << connection->sessionID << ": " << e.what() << std::endl;
+                    connection->client.close();
+                    connection->inFlight.clear();
+                }
+            }
+        }
+        });
+
+    uint64_t framesSent = 0;
+    auto replayStart = Clock::now();
+
+    try {
+        CaptureReader reader(options.capturePath);
+        CaptureRecord record;
+        bool firstRecord = true;
+        uint64_t firstTimestampNs = 0;
+
+        while (reader.next(record)) {
+            if (firstRecord) {
+                firstTimestampNs = record.timestampNs;
+                replayStart = Clock::now();
+                firstRecord = false;
+            }
+            if (options.speed > 0) {
+                auto offset = std::chrono::nanoseconds(static_cast<int64_t>((record.timestampNs - firstTimestampNs) / options.speed));
+                std::this_thread::sleep_until(replayStart + offset);
+            }
+
+            if (record.kind == CaptureKind::Open) {
+                auto connection = std::make_unique<ReplayConnection>();
+                connection->client.connect(options.host, options.port);
+
+                std::string greeting;
+                if (!connection->client.receive(greeting, 5000)) {
+                    throw std::runtime_error("Timed out waiting for session assignment");
+                }
+                connection->sessionID = nlohmann::json::parse(greeting).at("sessionID").get<std::string>();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                connections[record.connectionID] = std::move(connection);
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = connections.find(record.connectionID);
+            if (it == connections.end() || !it->second->client.isOpen()) {
+                // The capture started after this connection opened; nothing to replay it on.
+                continue;
+            }
+            ReplayConnection& connection = *it->second;
+
+            if (record.kind == CaptureKind::Close) {
+                connection.closing = true;
+                if (connection.inFlight.empty()) {
+                    connection.client.close();
+                }
+                continue;
+            }
+
+            if (record.kind == CaptureKind::Binary) {
+                connection.client.sendBinary(record.payload);
+                ++framesSent;
+                continue;
+            }
+
+            std::string action = "invalid";
+            std::string outgoing = record.payload;
+            auto json = nlohmann::json::parse(record.payload, nullptr, false);
+            if (json.is_object()) {
+                action = json.value("action", "unknown");
+                if (json.contains("sessionID")) {
+                    json["sessionID"] = connection.sessionID;
+                    outgoing = json.dump();
+                }
+            }
+
+            connection.inFlight.push_back({ action, Clock::now() });
+            connection.client.sendText(outgoing);
+            ++framesSent;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[ERROR] Replay aborted: " << e.what() << std::endl;
+    }
+
+    auto drainDeadline = Clock::now() + std::chrono::seconds(10);
+    while (Clock::now() < drainDeadline) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bool drained = std::all_of(connections.begin(), connections.end(),
+                [](const auto& entry) { return entry.second->inFlight.empty(); });
+            if (drained) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto replayEnd = Clock::now();
+
+    receiving.store(false);
+    receiver.join();
+
+    uint64_t unanswered = 0;
+    for (auto& [connectionID, connection] : connections) {
+        unanswered += connection->inFlight.size();
+        connection->client.close();
+    }
+
+    double elapsedSeconds = std::chrono::duration<double>(replayEnd - replayStart).count();
+    std::cout << "Replayed " << framesSent << " frames over " << connections.size() << " connections in "
+        << std::fixed << std::setprecision(3) << elapsedSeconds << " s";
+    if (elapsedSeconds > 0) {
+        std::cout << " (" << std::setprecision(0) << framesSent / elapsedSeconds << " frames/s)";
+    }
+    std::cout << "\n";
+    if (unanswered || unmatchedResponses) {
+        std::cout << "Unanswered requests: " << unanswered << ", unmatched responses: " << unmatchedResponses << "\n";
+    }
+
+    std::cout << "\n" << std::left << std::setw(14) << "action" << std::right
+        << std::setw(10) << "count" << std::setw(12) << "p50 us" << std::setw(12) << "p90 us"
+        << std::setw(12) << "p99 us" << std::setw(12) << "max us" << "\n";
+    std::cout << std::setprecision(1);
+    for (auto& [action, samples] : latenciesUs) {
+        std::sort(samples.begin(), samples.end());
+        std::cout << std::left << std::setw(14) << action << std::right
+            << std::setw(10) << samples.size()
+            << std::setw(12) << percentile(samples, 0.50)
+            << std::setw(12) << percentile(samples, 0.90)
+            << std::setw(12) << percentile(samples, 0.99)
+            << std::setw(12) << samples.back() << "\n";
+    }
+
+    return 0;
+}
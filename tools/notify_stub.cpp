@@ -0,0 +1,181 @@
+// Minimal org.freedesktop.Notifications service for testing the Linux backend without a
+// desktop. Prints every Notify and CloseNotification call it receives.
+//
+//     eval $(dbus-launch --sh-syntax)     # or: dbus-daemon --session --fork --print-address
+//     notify_stub &
+//     notifier
+//
+// Usage: notify_stub [--quiet]
+
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <dbus/dbus.h>
+
+namespace {
+    constexpr const char* NOTIFICATIONS_SERVICE = "org.freedesktop.Notifications";
+    constexpr const char* NOTIFICATIONS_PATH = "/org/freedesktop/Notifications";
+    constexpr const char* NOTIFICATIONS_INTERFACE = "org.freedesktop.Notifications";
+    // Reason code 3: closed by a call to CloseNotification.
+    constexpr dbus_uint32_t CLOSED_BY_CALL = 3;
+
+    volatile std::sig_atomic_t keepRunning = 1;
+    bool quiet = false;
+    dbus_uint32_t nextID = 1;
+    uint64_t notifyCalls = 0;
+    uint64_t replacements = 0;
+
+    void handleSignal(int) {
+        keepRunning = 0;
+    }
+
+    DBusMessage* handleNotify(DBusMessage* call) {
+        DBusMessageIter arguments;
+        const char* strings[4] = { "", "", "", "" };
+        dbus_uint32_t replacesID = 0;
+
+        // Signature: s u s s s as a{sv} i; only the leading basic arguments matter here.
+        if (!dbus_message_iter_init(call, &arguments) || strcmp(dbus_message_get_signature(call), "susssasa{sv}i") != 0) {
+            return dbus_message_new_error(call, DBUS_ERROR_INVALID_ARGS, "Expected signature susssasa{sv}i");
+        }
+        dbus_message_iter_get_basic(&arguments, &strings[0]);
+        dbus_message_iter_next(&arguments);
+        dbus_message_iter_get_basic(&arguments, &replacesID);
+        for (int i = 1; i < 4; ++i) {
+            dbus_message_iter_next(&arguments);
+            dbus_message_iter_get_basic(&arguments, &strings[i]);
+        }
+
+        ++notifyCalls;
+        dbus_uint32_t id = replacesID;
+        if (replacesID == 0) {
+            id = nextID++;
+        }
+        else {
+            ++replacements;
+        }
+        if (!quiet) {
+            std::cout << "[Notify] id=" << id << " replaces=" << replacesID << " app=\"" << strings[0]
+                << "\" summary=\"" << strings[2] << "\" body=\"" << strings[3] << "\"" << std::endl;
+        }
+
+        DBusMessage* reply = dbus_message_new_method_return(call);
+        dbus_message_append_args(reply, DBUS_TYPE_UINT32, &id, DBUS_TYPE_INVALID);
+        return reply;
+    }
+
+    DBusMessage* handleClose(DBusConnection* connection, DBusMessage* call) {
+        dbus_uint32_t id = 0;
+        if (!dbus_message_get_args(call, nullptr, DBUS_TYPE_UINT32, &id, DBUS_TYPE_INVALID)) {
+            return dbus_message_new_error(call, DBUS_ERROR_INVALID_ARGS, "Expected a notification ID");
+        }
+        if (!quiet) {
+            std::cout << "[CloseNotification] id=" << id << std::endl;
+        }
+
+        DBusMessage* closed = dbus_message_new_signal(NOTIFICATIONS_PATH, NOTIFICATIONS_INTERFACE, "NotificationClosed");
+        dbus_uint32_t reason = CLOSED_BY_CALL;
+        dbus_message_append_args(closed, DBUS_TYPE_UINT32, &id, DBUS_TYPE_UINT32, &reason, DBUS_TYPE_INVALID);
+        dbus_connection_send(connection, closed, nullptr);
+        dbus_message_unref(closed);
+        return dbus_message_new_method_return(call);
+    }
+
+    DBusMessage* handleCapabilities(DBusMessage* call) {
+        DBusMessage* reply = dbus_message_new_method_return(call);
+        DBusMessageIter arguments, capabilities;
+        const char* body = "body";
+        dbus_message_iter_init_append(reply, &arguments);
+        dbus_message_iter_open_container(&arguments, DBUS_TYPE_ARRAY, DBUS_TYPE_STRING_AS_STRING, &capabilities);
+        dbus_message_iter_append_basic(&capabilities, DBUS_TYPE_STRING, &body);
+        dbus_message_iter_close_container(&arguments, &capabilities);
+        return reply;
+    }
+
+    DBusMessage* handleServerInformation(DBusMessage* call) {
+        DBusMessage* reply = dbus_message_new_method_return(call);
+        const char* name = "notify_stub";
+        const char* vendor = "Lightweight Notifier";
+        const char* version = "1.0";
+        const char* specVersion = "1.2";
+        dbus_message_append_args(reply, DBUS_TYPE_STRING, &name, DBUS_TYPE_STRING, &vendor,
+            DBUS_TYPE_STRING, &version, DBUS_TYPE_STRING, &specVersion, DBUS_TYPE_INVALID);
+        return reply;
+    }
+
+    DBusHandlerResult handleMessage(DBusConnection* connection, DBusMessage* message, void*) {
+        if (dbus_message_get_type(message) != DBUS_MESSAGE_TYPE_METHOD_CALL ||
+            !dbus_message_has_interface(message, NOTIFICATIONS_INTERFACE)) {
+            return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+        }
+
+        DBusMessage* reply;
+        if (dbus_message_is_method_call(message, NOTIFICATIONS_INTERFACE, "Notify")) {
+            reply = handleNotify(message);
+        }
+        else if (dbus_message_is_method_call(message, NOTIFICATIONS_INTERFACE, "CloseNotification")) {
+            reply = handleClose(connection, message);
+        }
+        else if (dbus_message_is_method_call(message, NOTIFICATIONS_INTERFACE, "GetCapabilities")) {
+            reply = handleCapabilities(message);
+        }
+        else if (dbus_message_is_method_call(message, NOTIFICATIONS_INTERFACE, "GetServerInformation")) {
+            reply = handleServerInformation(message);
+        }
+        else {
+            reply = dbus_message_new_error(message, DBUS_ERROR_UNKNOWN_METHOD, "Unknown method");
+        }
+
+        if (!dbus_message_get_no_reply(message)) {
+            dbus_connection_send(connection, reply, nullptr);
+        }
+        dbus_message_unref(reply);
+        return DBUS_HANDLER_RESULT_HANDLED;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--quiet") {
+            quiet = true;
+        }
+        else {
+            std::cout << "Usage: " << argv[0] << " [--quiet]\n"
+                << "  --quiet  Only print totals on exit\n";
+            return std::string(argv[i]) == "--help" ? 0 : 1;
+        }
+    }
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    DBusError error;
+    dbus_error_init(&error);
+    DBusConnection* connection = dbus_bus_get_private(DBUS_BUS_SESSION, &error);
+    if (!connection) {
+        std::cerr << "[ERROR] Could not connect to the session bus: " << error.message << std::endl;
+        dbus_error_free(&error);
+        return 1;
+    }
+    dbus_connection_set_exit_on_disconnect(connection, FALSE);
+
+    int result = dbus_bus_request_name(connection, NOTIFICATIONS_SERVICE, DBUS_NAME_FLAG_DO_NOT_QUEUE, &error);
+    if (result != DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER) {
+        std::cerr << "[ERROR] Could not own " << NOTIFICATIONS_SERVICE << ": "
+            << (dbus_error_is_set(&error) ? error.message : "another notification service is running") << std::endl;
+        dbus_error_free(&error);
+        return 1;
+    }
+    dbus_connection_add_filter(connection, handleMessage, nullptr, nullptr);
+    std::cout << "[INFO] Serving " << NOTIFICATIONS_SERVICE << " on the session bus." << std::endl;
+
+    while (keepRunning && dbus_connection_read_write_dispatch(connection, 200)) {
+    }
+
+    std::cout << "[INFO] " << notifyCalls << " Notify calls, " << replacements << " replacements." << std::endl;
+    dbus_connection_close(connection);
+    dbus_connection_unref(connection);
+    return 0;
+}
@@ -0,0 +1,204 @@
+// Benchmark for the shared-memory ingest ring (Linux only). Runs producers and a
+// consumer in one process over the same rings and wakeup protocol the notifier uses,
+// and reports enqueue latency and ring throughput. It does not involve the notifier, so
+// applying records to NotificationManager is not included.
+//
+// Usage: shm_bench [--producers <n>] [--records <n>] [--capacity <n>]
+
+#include "shmRing.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+    size_t producers = 4;
+    size_t records = 2000000;
+    uint32_t capacity = 8 * 1024;
+};
+
+// Every SAMPLE_INTERVAL-th push is timed individually for the percentiles.
+constexpr size_t SAMPLE_INTERVAL = 64;
+
+static void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [--producers <n>] [--records <n>] [--capacity <n>]\n"
+        << "  --producers <n>  Producer threads (default 4)\n"
+        << "  --records <n>    Records per producer (default 2000000)\n"
+        << "  --capacity <n>   Slots in each producer's ring, a power of two (default 8192)\n";
+}
+
+static bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--producers" && i + 1 < argc) {
+            options.producers = std::stoul(argv[++i]);
+        }
+        else if (arg == "--records" && i + 1 < argc) {
+            options.records = std::stoul(argv[++i]);
+        }
+        else if (arg == "--capacity" && i + 1 < argc) {
+            options.capacity = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else {
+            return false;
+        }
+    }
+    return options.producers > 0 && options.capacity > 0 && (options.capacity & (options.capacity - 1)) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // One ring per producer, as the notifier hands out.
+    size_t ringBytes = shmRingBytes(options.capacity);
+    int wakeupFd = ::eventfd(0, EFD_CLOEXEC);
+    std::vector<ShmRingHeader*> rings;
+    for (size_t p = 0; p < options.producers; ++p) {
+        void* mapping = ::mmap(nullptr, ringBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED || wakeupFd < 0) {
+            std::cerr << "[ERROR] Failed to set up the rings." << std::endl;
+            return 1;
+        }
+        rings.push_back(static_cast<ShmRingHeader*>(mapping));
+        shmRingInit(rings.back(), options.capacity);
+    }
+
+    const size_t total = options.producers * options.records;
+    std::atomic<bool> start(false);
+    std::atomic<uint64_t> fullRetries(0);
+    std::vector<std::vector<double>> samples(options.producers);
+    std::vector<double> pushNanoseconds(options.producers);
+
+    uint64_t wakeups = 0;
+    std::thread consumer([&]() {
+        std::vector<uint64_t> readPositions(rings.size(), 0);
+        size_t consumed = 0;
+        uint64_t checksum = 0;
+        while (consumed < total) {
+            for (size_t r = 0; r < rings.size(); ++r) {
+                uint64_t available = shmRingAvailable(rings[r], readPositions[r], options.capacity);
+                for (uint64_t i = 0; i < available; ++i) {
+                    const ShmSlot* slot = shmRingSlot(rings[r], readPositions[r] + i, options.capacity);
+                    checksum += slot->record.clientKey + slot->record.titleLength;
+                }
+                if (available) {
+                    readPositions[r] += available;
+                    shmRingRelease(rings[r], readPositions[r]);
+                    consumed += available;
+                }
+            }
+            if (consumed >= total) {
+                break;
+            }
+
+            bool idle = true;
+            for (size_t r = 0; r < rings.size() && idle; ++r) {
+                idle = shmRingPrepareSleep(rings[r], readPositions[r], options.capacity);
+            }
+            if (idle) {
+                uint64_t count;
+                [[maybe_unused]] auto bytesRead = ::read(wakeupFd, &count, sizeof(count));
+                ++wakeups;
+            }
+            for (auto* ring : rings) {
+                ring->consumerSleeping.store(0, std::memory_order_relaxed);
+            }
+        }
+        if (checksum == 0) {
+            std::cerr << "[WARNING] Unexpected empty checksum." << std::endl;
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < options.producers; ++p) {
+        producers.emplace_back([&, p]() {
+            ShmRingHeader* ring = rings[p];
+            ShmRecord record{};
+            record.op = ShmOp::Update;
+            record.priority = 1;
+            const std::string title = "AAPL";
+            const std::string message = "Last 189.25 Bid 189.24 Ask 189.26";
+            samples[p].reserve(options.records / SAMPLE_INTERVAL + 1);
+
+            while (!start) {
+                std::this_thread::yield();
+            }
+            uint64_t retries = 0;
+            auto begin = Clock::now();
+            for (size_t i = 0; i < options.records; ++i) {
+                record.clientKey = i;
+                if (i % SAMPLE_INTERVAL == 0) {
+                    auto sampleStart = Clock::now();
+                    while (!shmRingPush(ring, wakeupFd, record, title, message)) {
+                        ++retries;
+                        std::this_thread::yield();
+                    }
+                    samples[p].push_back(std::chrono::duration<double, std::nano>(Clock::now() - sampleStart).count());
+                }
+                else {
+                    while (!shmRingPush(ring, wakeupFd, record, title, message)) {
+                        ++retries;
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            pushNanoseconds[p] = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+            fullRetries += retries;
+        });
+    }
+
+    auto begin = Clock::now();
+    start = true;
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    consumer.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    std::vector<double> latencies;
+    for (const auto& producerSamples : samples) {
+        latencies.insert(latencies.end(), producerSamples.begin(), producerSamples.end());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double fraction) {
+        return latencies.empty() ? 0.0 : latencies[std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()))];
+    };
+    double meanPush = 0;
+    for (double nanoseconds : pushNanoseconds) {
+        meanPush += nanoseconds / options.records;
+    }
+    meanPush /= options.producers;
+
+    std::cout << std::fixed << std::setprecision(1)
+        << "Producers:       " << options.producers << " x " << options.records << " records, ring of " << options.capacity << " slots\n"
+        << "Enqueue latency: mean " << meanPush << " ns, p50 " << percentile(0.50) << " ns, p99 " << percentile(0.99)
+        << " ns, max " << (latencies.empty() ? 0.0 : latencies.back()) << " ns\n"
+        << "Throughput:      " << std::setprecision(2) << total / seconds / 1e6 << " M records/s (" << seconds << " s)\n"
+        << "Ring full:       " << fullRetries.load() << " retries, consumer wakeups " << wakeups << std::endl;
+
+    for (auto* ring : rings) {
+        ::munmap(ring, ringBytes);
+    }
+    ::close(wakeupFd);
+    return 0;
+}